@@ -18,11 +18,15 @@
 #ifndef BEVENTS_EVENT_HPP_
 #define BEVENTS_EVENT_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include "EventPool.hpp"
 
 namespace BWidgets
 {
-class Widget;	// Forward declaration
+class Widget;			// Forward declaration
+class Window;			// Forward declaration
+class EventQueueable;	// Forward declaration
 }
 
 namespace BEvents
@@ -76,6 +80,20 @@ protected:
 	BWidgets::Widget* eventWidget_;
 	EventType eventType_;
 
+private:
+	// Intrusive links of the event queue (see BWidgets::EventQueueable)
+	friend class BWidgets::EventQueueable;
+	const BWidgets::EventQueueable* queue_;
+	Event* queuePrev_;
+	Event* queueNext_;
+
+	// Intrusive links of the queued events of the widget and of the
+	// request widget (see BWidgets::Window)
+	friend class BWidgets::Window;
+	Event* widgetPrev_;
+	Event* widgetNext_;
+	Event* requestPrev_;
+	Event* requestNext_;
 
 public:
 
@@ -94,14 +112,58 @@ public:
      *  @param type  EventType.
 	 */
 	Event (BWidgets::Widget* widget, const EventType type) :
-		eventWidget_ (widget), eventType_ (type) 
+		eventWidget_ (widget), eventType_ (type), 
+		queue_ (nullptr), queuePrev_ (nullptr), queueNext_ (nullptr),
+		widgetPrev_ (nullptr), widgetNext_ (nullptr), requestPrev_ (nullptr), requestNext_ (nullptr)
     {
 
+    }
+
+    /**
+	 *  @brief  Creates a copy of an %Event. The copy isn't queued.
+	 *  @param that  Other %Event.
+	 */
+	Event (const Event& that) :
+		eventWidget_ (that.eventWidget_), eventType_ (that.eventType_), 
+		queue_ (nullptr), queuePrev_ (nullptr), queueNext_ (nullptr),
+		widgetPrev_ (nullptr), widgetNext_ (nullptr), requestPrev_ (nullptr), requestNext_ (nullptr)
+    {
+
+    }
+
+    /**
+	 *  @brief  Assigns the content of another %Event. Doesn't change the
+	 *  queueing of this %Event.
+	 *  @param that  Other %Event.
+	 */
+	Event& operator= (const Event& that)
+    {
+        eventWidget_ = that.eventWidget_;
+        eventType_ = that.eventType_;
+        return *this;
     }
 
 	virtual ~Event () 
     {
 
+    }
+
+    /**
+     *  @brief  Allocates the memory for an %Event (or a derived event) from
+     *  the EventPool.
+     */
+    static void* operator new (const std::size_t size)
+    {
+        return EventPool::allocate (size);
+    }
+
+    /**
+     *  @brief  Returns the memory of an %Event (or a derived event) to the
+     *  EventPool.
+     */
+    static void operator delete (void* ptr, const std::size_t size)
+    {
+        EventPool::deallocate (ptr, size);
     }
 
 	/**
@@ -0,0 +1,220 @@
+/* EventPool.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEVENTS_EVENTPOOL_HPP_
+#define BEVENTS_EVENTPOOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#ifndef BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY
+#define BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY 32
+#endif
+
+#ifndef BEVENTS_DEFAULT_EVENT_POOL_MAX_BLOCK_SIZE
+#define BEVENTS_DEFAULT_EVENT_POOL_MAX_BLOCK_SIZE 512
+#endif
+
+#ifndef BEVENTS_DEFAULT_EVENT_POOL_SIZE
+#define BEVENTS_DEFAULT_EVENT_POOL_SIZE 256
+#endif
+
+namespace BEvents
+{
+
+/**
+ *  @brief  Memory pool for the allocation of events.
+ *
+ *  Recycles the memory blocks of deleted events instead of returning them to
+ *  the heap. The blocks are sorted into size classes of
+ *  BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY bytes. Each size class keeps up to
+ *  BEVENTS_DEFAULT_EVENT_POOL_SIZE free blocks. Blocks bigger than
+ *  BEVENTS_DEFAULT_EVENT_POOL_MAX_BLOCK_SIZE are directly taken from the
+ *  heap.
+ *
+ *  Each thread uses its own free lists. Thus, %EventPool doesn't need any
+ *  lock. Blocks allocated in one thread and deallocated in another thread
+ *  move to the free lists of the deallocating thread.
+ *
+ *  The Event class uses %EventPool for its @c operator new and
+ *  @c operator delete . Thus, all events created by @c new use the
+ *  %EventPool.
+ */
+class EventPool
+{
+public:
+
+	/**
+	 *  @brief  Allocation counters (of all threads).
+	 */
+	struct Statistics
+	{
+		uint64_t allocations;		// Number of all allocations
+		uint64_t heapAllocations;	// Number of allocations taken from the heap
+		uint64_t deallocations;		// Number of all deallocations
+	};
+
+	/**
+	 *  @brief  Allocates a memory block.
+	 *  @param size  Size in bytes.
+	 *  @return  Pointer to the memory block.
+	 */
+	static void* allocate (const size_t size)
+	{
+		getCounters().allocations.fetch_add (1, std::memory_order_relaxed);
+
+		const size_t c = sizeClass (size);
+		if ((c < nrClasses) && (!destroyed()))
+		{
+			FreeLists& lists = getFreeLists();
+			if (lists.heads[c])
+			{
+				Node* n = lists.heads[c];
+				lists.heads[c] = n->next;
+				--lists.sizes[c];
+				return n;
+			}
+		}
+
+		getCounters().heapAllocations.fetch_add (1, std::memory_order_relaxed);
+		return ::operator new (c < nrClasses ? (c + 1) * BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY : size);
+	}
+
+	/**
+	 *  @brief  Deallocates a memory block allocated by @c allocate() .
+	 *  @param ptr  Pointer to the memory block.
+	 *  @param size  Size in bytes as passed to @c allocate() .
+	 */
+	static void deallocate (void* ptr, const size_t size)
+	{
+		if (!ptr) return;
+		getCounters().deallocations.fetch_add (1, std::memory_order_relaxed);
+
+		const size_t c = sizeClass (size);
+		if ((c < nrClasses) && (!destroyed()))
+		{
+			FreeLists& lists = getFreeLists();
+			if (lists.sizes[c] < BEVENTS_DEFAULT_EVENT_POOL_SIZE)
+			{
+				Node* n = static_cast<Node*> (ptr);
+				n->next = lists.heads[c];
+				lists.heads[c] = n;
+				++lists.sizes[c];
+				return;
+			}
+		}
+
+		::operator delete (ptr);
+	}
+
+	/**
+	 *  @brief  Gets the allocation counters.
+	 *  @return  Statistics.
+	 */
+	static Statistics getStatistics ()
+	{
+		Counters& c = getCounters();
+		return Statistics
+		{
+			c.allocations.load (std::memory_order_relaxed),
+			c.heapAllocations.load (std::memory_order_relaxed),
+			c.deallocations.load (std::memory_order_relaxed)
+		};
+	}
+
+	/**
+	 *  @brief  Resets the allocation counters.
+	 */
+	static void resetStatistics ()
+	{
+		Counters& c = getCounters();
+		c.allocations.store (0, std::memory_order_relaxed);
+		c.heapAllocations.store (0, std::memory_order_relaxed);
+		c.deallocations.store (0, std::memory_order_relaxed);
+	}
+
+protected:
+	static constexpr size_t nrClasses =
+	(
+		(BEVENTS_DEFAULT_EVENT_POOL_MAX_BLOCK_SIZE + BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY - 1) /
+		BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY
+	);
+
+	struct Node
+	{
+		Node* next;
+	};
+
+	struct FreeLists
+	{
+		Node* heads[nrClasses] = {};
+		size_t sizes[nrClasses] = {};
+
+		~FreeLists ()
+		{
+			for (size_t c = 0; c < nrClasses; ++c)
+			{
+				while (heads[c])
+				{
+					Node* n = heads[c];
+					heads[c] = n->next;
+					::operator delete (n);
+				}
+			}
+
+			// Events deleted after the end of the thread (e.g., by static
+			// objects) directly return to the heap
+			destroyed() = true;
+		}
+	};
+
+	struct Counters
+	{
+		std::atomic<uint64_t> allocations {0};
+		std::atomic<uint64_t> heapAllocations {0};
+		std::atomic<uint64_t> deallocations {0};
+	};
+
+	static size_t sizeClass (const size_t size)
+	{
+		return (size == 0 ? 0 : (size - 1) / BEVENTS_DEFAULT_EVENT_POOL_GRANULARITY);
+	}
+
+	static FreeLists& getFreeLists ()
+	{
+		static thread_local FreeLists lists;
+		return lists;
+	}
+
+	static bool& destroyed ()
+	{
+		static thread_local bool d = false;
+		return d;
+	}
+
+	static Counters& getCounters ()
+	{
+		static Counters counters;
+		return counters;
+	}
+};
+
+}
+
+#endif /* BEVENTS_EVENTPOOL_HPP_ */
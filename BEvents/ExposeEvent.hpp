@@ -20,6 +20,7 @@
 
 #include "WidgetEvent.hpp"
 #include "../BUtilities/Area.hpp"
+#include "../BUtilities/Region.hpp"
 
 namespace BEvents
 {
@@ -31,11 +32,17 @@ namespace BEvents
  *  content of a child (request) widget is requested to be updated. An 
  *  %ExposeEvent additionally contains the coordinates (x, y, width and height)
  *  of the output region (relative to the widgets origin) to be updated.
+ *
+ *  The output region may consist of multiple disjoint areas (e.g., if 
+ *  expose requests for distant widgets are merged). In this case, 
+ *  @c getArea() returns the bounding box and @c getRegion() returns the 
+ *  individual areas.
  */
 class ExposeEvent : public WidgetEvent
 {
 protected:
 	BUtilities::Area<> exposeArea_;
+	BUtilities::Region<> exposeRegion_;
 
 public:
 
@@ -77,7 +84,8 @@ public:
 	ExposeEvent (BWidgets::Widget* eventWidget, BWidgets::Widget* requestWidget, const EventType type,
 		         const BUtilities::Area<>& area) :
 		WidgetEvent (eventWidget, requestWidget, type),
-		exposeArea_ (area) 
+		exposeArea_ (area),
+		exposeRegion_ (area) 
     {
 
     }
@@ -89,8 +97,29 @@ public:
 	virtual void setArea (const BUtilities::Area<>& area)
 	{
         exposeArea_ = area;
+		exposeRegion_ = BUtilities::Region<> (area);
     }
 
+	/**
+	 *  @brief  Adds an area to the output region.
+	 *  @param area  Area coordinates relative to the widgets origin.
+	 */
+	virtual void addArea (const BUtilities::Area<>& area)
+	{
+		if (exposeRegion_.empty()) exposeArea_ = area;
+		else exposeArea_.extend (area);
+		exposeRegion_.add (area);
+	}
+
+	/**
+	 *  @brief  Adds a region to the output region.
+	 *  @param region  Region coordinates relative to the widgets origin.
+	 */
+	virtual void addArea (const BUtilities::Region<>& region)
+	{
+		for (const BUtilities::Area<>& a : region) addArea (a);
+	}
+
 	/**
 	 *  @brief  Gets the area coordinates of the output region.
 	 *  @return  Area coordinates relative to the widgets origin.
@@ -99,6 +128,15 @@ public:
 	{
         return exposeArea_;
     }
+
+	/**
+	 *  @brief  Gets the disjoint areas of the output region.
+	 *  @return  Region relative to the widgets origin.
+	 */
+	const BUtilities::Region<>& getRegion () const
+	{
+		return exposeRegion_;
+	}
 };
 
 }
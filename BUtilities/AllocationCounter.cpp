@@ -0,0 +1,130 @@
+/* AllocationCounter.cpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.hpp"
+
+#ifdef BUTILITIES_ALLOCATION_COUNTER
+
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/*
+ *  Replacement of the global operator new and operator delete. Counts all
+ *  allocations (see AllocationCounter) and forwards them to malloc() and
+ *  free(). Aligned allocations are forwarded to _aligned_malloc() and 
+ *  _aligned_free() on Windows and to posix_memalign() and free() otherwise.
+ */
+
+static void* alignedMalloc (const std::size_t size, std::size_t alignment)
+{
+#ifdef _WIN32
+	return _aligned_malloc (size, alignment);
+#else
+	if (alignment < sizeof (void*)) alignment = sizeof (void*);
+	void* ptr = nullptr;
+	return (posix_memalign (&ptr, alignment, size) == 0 ? ptr : nullptr);
+#endif
+}
+
+static void alignedFree (void* ptr) noexcept
+{
+#ifdef _WIN32
+	_aligned_free (ptr);
+#else
+	std::free (ptr);
+#endif
+}
+
+static void* allocate (std::size_t size, const std::size_t alignment, const bool aligned)
+{
+	BUtilities::AllocationCounter::add (size);
+	if (size == 0) size = 1;
+
+	while (true)
+	{
+		void* ptr = (aligned ? alignedMalloc (size, alignment) : std::malloc (size));
+		if (ptr) return ptr;
+
+		std::new_handler handler = std::get_new_handler();
+		if (!handler) return nullptr;
+		handler();
+	}
+}
+
+void* operator new (std::size_t size)
+{
+	void* ptr = allocate (size, alignof (std::max_align_t), false);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[] (std::size_t size)
+{
+	return operator new (size);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+	try {return allocate (size, alignof (std::max_align_t), false);}
+	catch (...) {return nullptr;}
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new (size, tag);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+	void* ptr = allocate (size, static_cast<std::size_t> (alignment), true);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+	return operator new (size, alignment);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try {return allocate (size, static_cast<std::size_t> (alignment), true);}
+	catch (...) {return nullptr;}
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return operator new (size, alignment, tag);
+}
+
+void operator delete (void* ptr) noexcept {std::free (ptr);}
+void operator delete[] (void* ptr) noexcept {std::free (ptr);}
+void operator delete (void* ptr, std::size_t) noexcept {std::free (ptr);}
+void operator delete[] (void* ptr, std::size_t) noexcept {std::free (ptr);}
+void operator delete (void* ptr, const std::nothrow_t&) noexcept {std::free (ptr);}
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept {std::free (ptr);}
+void operator delete (void* ptr, std::align_val_t) noexcept {alignedFree (ptr);}
+void operator delete[] (void* ptr, std::align_val_t) noexcept {alignedFree (ptr);}
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept {alignedFree (ptr);}
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept {alignedFree (ptr);}
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {alignedFree (ptr);}
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {alignedFree (ptr);}
+
+#endif /* BUTILITIES_ALLOCATION_COUNTER */
@@ -0,0 +1,195 @@
+/* AllocationCounter.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_ALLOCATIONCOUNTER_HPP_
+#define BUTILITIES_ALLOCATIONCOUNTER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ *  Allocations are only counted if BUTILITIES_ALLOCATION_COUNTER is defined
+ *  for all translation units (including the BWidgets core library). Then,
+ *  AllocationCounter.cpp replaces the global operator new. Otherwise,
+ *  BUTILITIES_ALLOCATION_SCOPE expands to nothing and its argument is not
+ *  evaluated.
+ */
+#ifdef BUTILITIES_ALLOCATION_COUNTER
+#define BUTILITIES_ALLOCATION_CONCAT_(a, b) a##b
+#define BUTILITIES_ALLOCATION_CONCAT(a, b) BUTILITIES_ALLOCATION_CONCAT_(a, b)
+#define BUTILITIES_ALLOCATION_SCOPE(...) BUtilities::AllocationCounter::Scope BUTILITIES_ALLOCATION_CONCAT(allocationScope_, __LINE__) (__VA_ARGS__)
+#else
+#define BUTILITIES_ALLOCATION_SCOPE(...) ((void)0)
+#endif /* BUTILITIES_ALLOCATION_COUNTER */
+
+namespace BUtilities
+{
+
+/**
+ *  @brief  Counter for heap allocations by phase.
+ *
+ *  Counts the number and the size of all allocations via @c operator new
+ *  (of all threads) while a phase is set for the allocating thread. Use
+ *  the macro BUTILITIES_ALLOCATION_SCOPE (phase) to set the phase for a
+ *  scope. Scopes can be nested. The innermost phase wins.
+ *
+ *  By default, allocations are added to process-global counters. Use
+ *  BUTILITIES_ALLOCATION_SCOPE (phase, &sink) to add them to the counters
+ *  of a Sink instead (e. g., one per Window). Thus, multiple instances
+ *  (like multiple plugin GUIs) in one process don't take each others
+ *  counts.
+ *
+ *  Allocations via @c malloc() (e. g., within Cairo) are not counted.
+ */
+class AllocationCounter
+{
+public:
+
+	/**
+	 *  @brief  Phases of a frame.
+	 */
+	enum Phase
+	{
+		dispatchPhase,
+		drawPhase,
+		compositePhase,
+		nrPhases			// Also used for: no phase set
+	};
+
+	/**
+	 *  @brief  Allocation counters of a phase.
+	 */
+	struct Statistics
+	{
+		unsigned long count;	// Number of allocations
+		size_t bytes;			// Allocated bytes
+	};
+
+protected:
+	struct Counters
+	{
+		std::atomic<unsigned long> count {0};
+		std::atomic<size_t> bytes {0};
+	};
+
+public:
+
+	/**
+	 *  @brief  Target for allocation counts by phase.
+	 */
+	class Sink
+	{
+	protected:
+		friend class AllocationCounter;
+		Counters counters_[nrPhases];
+	};
+
+	/**
+	 *  @brief  Sets the phase (and optionally the sink) for the calling 
+	 *  thread within a scope.
+	 */
+	class Scope
+	{
+	protected:
+		Phase previousPhase_;
+		Sink* previousSink_;
+
+	public:
+		explicit Scope (const Phase phase, Sink* sink = nullptr) :
+			previousPhase_ (currentPhase()),
+			previousSink_ (currentSink())
+		{
+			currentPhase() = phase;
+			currentSink() = (sink ? sink : &globalSink());
+		}
+
+		Scope (const Scope& that) = delete;
+		Scope& operator= (const Scope& that) = delete;
+
+		~Scope ()
+		{
+			currentPhase() = previousPhase_;
+			currentSink() = previousSink_;
+		}
+	};
+
+	/**
+	 *  @brief  Adds an allocation to the phase of the calling thread.
+	 *  @param bytes  Allocated bytes.
+	 *
+	 *  Called by @c operator new . Lock-free and allocation-free.
+	 */
+	static void add (const size_t bytes)
+	{
+		const Phase p = currentPhase();
+		if (p >= nrPhases) return;
+
+		Counters& c = currentSink()->counters_[p];
+		c.count.fetch_add (1, std::memory_order_relaxed);
+		c.bytes.fetch_add (bytes, std::memory_order_relaxed);
+	}
+
+	/**
+	 *  @brief  Gets the allocation counters of a phase.
+	 *  @param phase  Phase.
+	 *  @param sink  Optional, pointer to the sink. Default: global counters.
+	 *  @return  Statistics.
+	 */
+	static Statistics get (const Phase phase, Sink* sink = nullptr)
+	{
+		if (phase >= nrPhases) return Statistics {0, 0};
+		Counters& c = (sink ? sink : &globalSink())->counters_[phase];
+		return Statistics {c.count.load (std::memory_order_relaxed), c.bytes.load (std::memory_order_relaxed)};
+	}
+
+	/**
+	 *  @brief  Gets and resets the allocation counters of a phase.
+	 *  @param phase  Phase.
+	 *  @param sink  Optional, pointer to the sink. Default: global counters.
+	 *  @return  Statistics.
+	 */
+	static Statistics take (const Phase phase, Sink* sink = nullptr)
+	{
+		if (phase >= nrPhases) return Statistics {0, 0};
+		Counters& c = (sink ? sink : &globalSink())->counters_[phase];
+		return Statistics {c.count.exchange (0, std::memory_order_relaxed), c.bytes.exchange (0, std::memory_order_relaxed)};
+	}
+
+protected:
+	static Sink& globalSink ()
+	{
+		static Sink sink;
+		return sink;
+	}
+
+	static Sink*& currentSink ()
+	{
+		static thread_local Sink* sink = &globalSink();
+		return sink;
+	}
+
+	static Phase& currentPhase ()
+	{
+		static thread_local Phase phase = nrPhases;
+		return phase;
+	}
+};
+
+}
+
+#endif /* BUTILITIES_ALLOCATIONCOUNTER_HPP_ */
@@ -0,0 +1,165 @@
+/* MpscQueue.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_MPSCQUEUE_HPP_
+#define BUTILITIES_MPSCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace BUtilities
+{
+
+/**
+ *  @brief  Bounded wait-free multi producer single consumer queue.
+ *  @tparam T  Trivially copyable data type.
+ *
+ *  Based on the intrusive MPSC queue by Dmitry Vyukov. The elements are 
+ *  stored in a fixed pool of nodes. Producers take the next node of the
+ *  pool in round robin order and link it to the tail with a single atomic
+ *  exchange. Thus, producers never retry, never block, and never allocate.
+ *  If the next node is still in use (the queue is full), @c push() fails
+ *  immediately. Only one thread may call @c pop() .
+ */
+template <class T>
+class MpscQueue
+{
+	static_assert (std::is_trivially_copyable<T>::value, "MpscQueue requires trivially copyable data");
+
+protected:
+	struct Node
+	{
+		std::atomic<Node*> next;
+		std::atomic<bool> used;
+		T data;
+	};
+
+	std::unique_ptr<Node[]> nodes_;
+	size_t mask_;
+	Node stub_;
+	alignas (64) std::atomic<size_t> nodePos_;
+	alignas (64) std::atomic<Node*> tail_;
+	alignas (64) Node* head_;
+
+public:
+
+	/**
+	 *  @brief  Creates an empty %MpscQueue.
+	 *  @param size  Capacity. Will be rounded up to the next power of two.
+	 */
+	explicit MpscQueue (const size_t size) :
+		nodes_ (),
+		mask_ (0),
+		stub_ (),
+		nodePos_ (0),
+		tail_ (&stub_),
+		head_ (&stub_)
+	{
+		size_t s = 2;
+		while (s < size) s <<= 1;
+		nodes_.reset (new Node[s]);
+		mask_ = s - 1;
+		for (size_t i = 0; i < s; ++i)
+		{
+			nodes_[i].next.store (nullptr, std::memory_order_relaxed);
+			nodes_[i].used.store (false, std::memory_order_relaxed);
+		}
+		stub_.next.store (nullptr, std::memory_order_relaxed);
+		stub_.used.store (true, std::memory_order_relaxed);
+	}
+
+	MpscQueue (const MpscQueue& that) = delete;
+	MpscQueue& operator= (const MpscQueue& that) = delete;
+
+	/**
+	 *  @brief  Gets the capacity of the %MpscQueue.
+	 *  @return  Capacity.
+	 */
+	size_t capacity () const {return mask_ + 1;}
+
+	/**
+	 *  @brief  Adds an element to the end of the %MpscQueue. May be called
+	 *  by any thread.
+	 *  @param data  Element.
+	 *  @return  True on success, false if the queue is full.
+	 */
+	bool push (const T& data)
+	{
+		// Take the next node of the pool. Still used: full
+		Node* node = &nodes_[nodePos_.fetch_add (1, std::memory_order_relaxed) & mask_];
+		if (node->used.exchange (true, std::memory_order_acquire)) return false;
+
+		node->data = data;
+		link (node);
+		return true;
+	}
+
+	/**
+	 *  @brief  Removes the first element of the %MpscQueue. Must only be
+	 *  called by the consumer thread.
+	 *  @param data  Reference to take up the element.
+	 *  @return  True on success, false if the queue is empty.
+	 *
+	 *  An element may be temporarily invisible to @c pop() while its 
+	 *  producer is still linking it.
+	 */
+	bool pop (T& data)
+	{
+		Node* head = head_;
+		Node* next = head->next.load (std::memory_order_acquire);
+
+		// Skip the stub
+		if (head == &stub_)
+		{
+			if (!next) return false;
+			head_ = next;
+			head = next;
+			next = next->next.load (std::memory_order_acquire);
+		}
+
+		if (!next)
+		{
+			// Last node is not linked yet
+			if (head != tail_.load (std::memory_order_acquire)) return false;
+
+			// Re-insert the stub behind the last node, thus it can be taken
+			link (&stub_);
+			next = head->next.load (std::memory_order_acquire);
+			if (!next) return false;
+		}
+
+		head_ = next;
+		data = head->data;
+		head->used.store (false, std::memory_order_release);
+		return true;
+	}
+
+protected:
+	void link (Node* node)
+	{
+		node->next.store (nullptr, std::memory_order_relaxed);
+		Node* prev = tail_.exchange (node, std::memory_order_acq_rel);
+		prev->next.store (node, std::memory_order_release);
+	}
+};
+
+}
+
+#endif /* BUTILITIES_MPSCQUEUE_HPP_ */
@@ -0,0 +1,244 @@
+/* Region.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_REGION_HPP_
+#define BUTILITIES_REGION_HPP_
+
+#include <vector>
+#include "Area.hpp"
+
+namespace BUtilities
+{
+
+/**
+ *  @brief  2D region composed of a list of disjoint rectangular areas.
+ *  @tparam T  Data type of the coordinates.
+ *
+ *  Similar to cairo_region_t. Adding an Area only adds the parts of the Area
+ *  which are not covered by the %Region yet. Thus, the areas of a %Region
+ *  never overlap.
+ */
+template <class T = double>
+class Region
+{
+protected:
+	std::vector<Area<T>> areas_;
+
+public:
+	typedef typename std::vector<Area<T>>::const_iterator const_iterator;
+
+	/**
+	 *  @brief  Constructs a new empty %Region object.
+	 */
+	Region () : areas_ () {}
+
+	/**
+	 *  @brief  Constructs a new %Region object from an Area.
+	 *  @param area  Area.
+	 */
+	explicit Region (const Area<T>& area) : Region () {add (area);}
+
+	/**
+	 *  @brief  Tests if the %Region doesn't contain any area.
+	 *  @return  True, if empty, otherwise false.
+	 */
+	bool empty () const {return areas_.empty();}
+
+	/**
+	 *  @brief  Gets the number of the disjoint areas of the %Region.
+	 *  @return  Number of areas.
+	 */
+	size_t size () const {return areas_.size();}
+
+	/**
+	 *  @brief  Removes all areas from the %Region.
+	 */
+	void clear () {areas_.clear();}
+
+	const_iterator begin () const {return areas_.cbegin();}
+	const_iterator end () const {return areas_.cend();}
+
+	/**
+	 *  @brief  Gets the bounding box of the %Region.
+	 *  @return  Area including all areas of the %Region.
+	 */
+	Area<T> getArea () const
+	{
+		if (areas_.empty()) return Area<T> ();
+		Area<T> a = areas_.front();
+		for (const Area<T>& r : areas_) a.extend (r);
+		return a;
+	}
+
+	/**
+	 *  @brief  Tests if an Area overlaps the %Region.
+	 *  @param area  Area.
+	 *  @return  True, if @a area and the %Region share a common part,
+	 *  otherwise false.
+	 */
+	bool overlaps (const Area<T>& area) const
+	{
+		for (const Area<T>& r : areas_)
+		{
+			if (intersects (r, area)) return true;
+		}
+		return false;
+	}
+
+	/**
+	 *  @brief  Adds the not yet covered parts of an Area to the %Region.
+	 *  @param area  Area.
+	 */
+	void add (const Area<T>& area)
+	{
+		if ((area.getWidth() <= T()) || (area.getHeight() <= T())) return;
+
+		// Split area into parts not covered by the existing areas
+		std::vector<Area<T>> parts = {area};
+		for (typename std::vector<Area<T>>::iterator it = areas_.begin(); it != areas_.end(); /* empty */)
+		{
+			// Drop existing areas fully covered by the new area
+			if (area.includes (*it))
+			{
+				it = areas_.erase (it);
+				continue;
+			}
+
+			std::vector<Area<T>> nextParts;
+			for (const Area<T>& p : parts) cut (p, *it, nextParts);
+			parts = nextParts;
+			if (parts.empty()) return;
+			++it;
+		}
+
+		areas_.insert (areas_.end(), parts.begin(), parts.end());
+	}
+
+	/**
+	 *  @brief  Adds all areas of another %Region to this %Region.
+	 *  @param region  Other %Region.
+	 */
+	void add (const Region& region)
+	{
+		for (const Area<T>& r : region.areas_) add (r);
+	}
+
+	/**
+	 *  @brief  Removes an Area from the %Region.
+	 *  @param area  Area.
+	 */
+	void subtract (const Area<T>& area)
+	{
+		std::vector<Area<T>> nextAreas;
+		for (const Area<T>& r : areas_) cut (r, area, nextAreas);
+		areas_ = nextAreas;
+	}
+
+	/**
+	 *  @brief  Changes this %Region to the intersection of this %Region and
+	 *  an Area.
+	 *  @param area  Area.
+	 */
+	void intersect (const Area<T>& area)
+	{
+		std::vector<Area<T>> nextAreas;
+		for (const Area<T>& r : areas_)
+		{
+			if (intersects (r, area)) nextAreas.push_back (r * area);
+		}
+		areas_ = nextAreas;
+	}
+
+	/**
+	 *  @brief  Adds the not yet covered parts of an Area to the %Region.
+	 *  @param rhs  Area.
+	 *  @return  Result of the union.
+	 */
+	Region& operator+= (const Area<T>& rhs)
+	{
+		add (rhs);
+		return *this;
+	}
+
+	/**
+	 *  @brief  Adds the not yet covered parts of another %Region to this
+	 *  %Region.
+	 *  @param rhs  Other %Region.
+	 *  @return  Result of the union.
+	 */
+	Region& operator+= (const Region& rhs)
+	{
+		add (rhs);
+		return *this;
+	}
+
+	/**
+	 *  @brief  Changes this %Region to intersect with an Area.
+	 *  @param rhs  Area.
+	 *  @return  Result of the intersection.
+	 */
+	Region& operator*= (const Area<T>& rhs)
+	{
+		intersect (rhs);
+		return *this;
+	}
+
+protected:
+	/**
+	 *  @brief  Tests if two areas share a common part with a non-zero size.
+	 *
+	 *  In contrast to Area::overlaps(), touching areas don't intersect.
+	 */
+	static bool intersects (const Area<T>& a, const Area<T>& b)
+	{
+		return	(a.getX() < b.getX() + b.getWidth()) && (b.getX() < a.getX() + a.getWidth()) &&
+				(a.getY() < b.getY() + b.getHeight()) && (b.getY() < a.getY() + a.getHeight());
+	}
+
+	/**
+	 *  @brief  Cuts the area @a b out of the area @a a and stores up to four
+	 *  remaining (disjoint) parts of @a a in @a parts .
+	 */
+	static void cut (const Area<T>& a, const Area<T>& b, std::vector<Area<T>>& parts)
+	{
+		if (!intersects (a, b))
+		{
+			parts.push_back (a);
+			return;
+		}
+
+		const T ax1 = a.getX();
+		const T ay1 = a.getY();
+		const T ax2 = ax1 + a.getWidth();
+		const T ay2 = ay1 + a.getHeight();
+		const T bx1 = b.getX();
+		const T by1 = b.getY();
+		const T bx2 = bx1 + b.getWidth();
+		const T by2 = by1 + b.getHeight();
+		const T y1 = (by1 > ay1 ? by1 : ay1);
+		const T y2 = (by2 < ay2 ? by2 : ay2);
+
+		if (by1 > ay1) parts.push_back (Area<T> (Point<T> (ax1, ay1), Point<T> (ax2, by1)));	// Top
+		if (by2 < ay2) parts.push_back (Area<T> (Point<T> (ax1, by2), Point<T> (ax2, ay2)));	// Bottom
+		if (bx1 > ax1) parts.push_back (Area<T> (Point<T> (ax1, y1), Point<T> (bx1, y2)));		// Left
+		if (bx2 < ax2) parts.push_back (Area<T> (Point<T> (bx2, y1), Point<T> (ax2, y2)));		// Right
+	}
+};
+
+}
+
+#endif /* BUTILITIES_REGION_HPP_ */
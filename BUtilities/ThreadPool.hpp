@@ -0,0 +1,163 @@
+/* ThreadPool.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_THREADPOOL_HPP_
+#define BUTILITIES_THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BUtilities
+{
+
+/**
+ *  @brief  Fixed-size pool of worker threads.
+ *
+ *  A %ThreadPool runs a batch of indexed jobs in parallel (see @c run() ).
+ *  The calling thread takes part in the processing of the jobs. Thus, a
+ *  %ThreadPool without any worker thread simply runs all jobs serially.
+ */
+class ThreadPool
+{
+protected:
+	std::vector<std::thread> threads_;
+	std::mutex mx_;
+	std::condition_variable startCv_;
+	std::condition_variable doneCv_;
+	std::function<void (const size_t)> job_;
+	size_t count_;
+	size_t next_;
+	size_t pending_;
+	bool quit_;
+
+public:
+
+	/**
+	 *  @brief  Creates a %ThreadPool and starts its worker threads.
+	 *  @param nrThreads  Optional, number of worker threads. Default (0) is
+	 *  the number of hardware threads minus one (the calling thread).
+	 */
+	explicit ThreadPool (size_t nrThreads = 0) :
+		threads_ (),
+		mx_ (),
+		startCv_ (),
+		doneCv_ (),
+		job_ (),
+		count_ (0),
+		next_ (0),
+		pending_ (0),
+		quit_ (false)
+	{
+		if (nrThreads == 0)
+		{
+			const unsigned int hw = std::thread::hardware_concurrency();
+			nrThreads = (hw > 1 ? hw - 1 : 0);
+		}
+
+		for (size_t i = 0; i < nrThreads; ++i) threads_.emplace_back ([this] () {work();});
+	}
+
+	ThreadPool (const ThreadPool& that) = delete;
+	ThreadPool& operator= (const ThreadPool& that) = delete;
+
+	/**
+	 *  @brief  Stops and joins all worker threads.
+	 */
+	~ThreadPool ()
+	{
+		{
+			std::lock_guard<std::mutex> lock (mx_);
+			quit_ = true;
+		}
+		startCv_.notify_all();
+		for (std::thread& t : threads_) t.join();
+	}
+
+	/**
+	 *  @brief  Gets the number of worker threads.
+	 *  @return  Number of worker threads.
+	 */
+	size_t size () const {return threads_.size();}
+
+	/**
+	 *  @brief  Runs a batch of jobs in parallel and waits until all jobs are
+	 *  done.
+	 *  @param count  Number of jobs.
+	 *  @param func  Function to be called for each job index
+	 *  [0 .. count - 1].
+	 *
+	 *  @a func must be thread-safe and must not throw.
+	 */
+	void run (const size_t count, std::function<void (const size_t)> func)
+	{
+		if (count == 0) return;
+
+		// Serial fallback
+		if (threads_.empty() || (count == 1))
+		{
+			for (size_t i = 0; i < count; ++i) func (i);
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock (mx_);
+		job_ = func;
+		count_ = count;
+		next_ = 0;
+		pending_ = count;
+		startCv_.notify_all();
+
+		// Take part
+		while (next_ < count_)
+		{
+			const size_t i = next_++;
+			lock.unlock();
+			func (i);
+			lock.lock();
+			--pending_;
+		}
+
+		doneCv_.wait (lock, [this] () {return pending_ == 0;});
+		job_ = nullptr;
+		count_ = 0;
+		next_ = 0;
+	}
+
+protected:
+	void work ()
+	{
+		std::unique_lock<std::mutex> lock (mx_);
+		while (true)
+		{
+			startCv_.wait (lock, [this] () {return quit_ || (next_ < count_);});
+			if (quit_) return;
+
+			const size_t i = next_++;
+			lock.unlock();
+			job_ (i);
+			lock.lock();
+			if (--pending_ == 0) doneCv_.notify_all();
+		}
+	}
+};
+
+}
+
+#endif /* BUTILITIES_THREADPOOL_HPP_ */
@@ -0,0 +1,229 @@
+/* Trace.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_TRACE_HPP_
+#define BUTILITIES_TRACE_HPP_
+
+/*
+ *  Tracing is compiled in only if BUTILITIES_TRACE is defined. Otherwise,
+ *  BUTILITIES_TRACE_SCOPE expands to nothing and its arguments are not
+ *  evaluated.
+ */
+#ifdef BUTILITIES_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#if defined(__GNUG__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+#ifndef BUTILITIES_DEFAULT_TRACE_SIZE
+#define BUTILITIES_DEFAULT_TRACE_SIZE 1048576
+#endif
+
+#define BUTILITIES_TRACE_CONCAT_(a, b) a##b
+#define BUTILITIES_TRACE_CONCAT(a, b) BUTILITIES_TRACE_CONCAT_(a, b)
+#define BUTILITIES_TRACE_SCOPE(category, name) BUtilities::Trace::Scope BUTILITIES_TRACE_CONCAT(traceScope_, __LINE__) (category, name)
+
+namespace BUtilities
+{
+
+/**
+ *  @brief  Recorder for Chrome trace events.
+ *
+ *  Records complete events ("ph": "X") of all threads and writes them in
+ *  the Chrome trace event JSON format. The written file can be loaded into
+ *  chrome://tracing or the Perfetto UI.
+ *
+ *  Use the macro BUTILITIES_TRACE_SCOPE (category, name) to record the
+ *  duration of a scope. Category and name must be string literals or
+ *  strings with static storage duration. Stops recording after
+ *  BUTILITIES_DEFAULT_TRACE_SIZE events.
+ */
+class Trace
+{
+public:
+
+	/**
+	 *  @brief  Records the duration of a scope.
+	 */
+	class Scope
+	{
+	protected:
+		const char* category_;
+		const char* name_;
+		std::chrono::steady_clock::time_point start_;
+
+	public:
+		Scope (const char* category, const char* name) :
+			category_ (category),
+			name_ (name),
+			start_ (std::chrono::steady_clock::now())
+		{}
+
+		Scope (const Scope& that) = delete;
+		Scope& operator= (const Scope& that) = delete;
+
+		~Scope ()
+		{
+			Trace::add (category_, name_, start_, std::chrono::steady_clock::now());
+		}
+	};
+
+	/**
+	 *  @brief  Adds a complete event.
+	 *  @param category  Category.
+	 *  @param name  Name.
+	 *  @param start  Start time.
+	 *  @param end  End time.
+	 */
+	static void add	(const char* category, const char* name,
+					 const std::chrono::steady_clock::time_point start,
+					 const std::chrono::steady_clock::time_point end)
+	{
+		Data& d = getData();
+		const uint32_t tid = getThreadIndex();
+		std::lock_guard<std::mutex> lock (d.mx);
+		if (d.events.size() >= BUTILITIES_DEFAULT_TRACE_SIZE) return;
+		d.events.push_back (Event {category, name, start, end, tid});
+	}
+
+	/**
+	 *  @brief  Gets the readable name of a type.
+	 *  @param type  Type info (e.g., from @c typeid ).
+	 *  @return  Demangled type name with static storage duration.
+	 *
+	 *  Each type name is demangled only once (GCC, Clang) and then cached.
+	 *  Other compilers already provide readable names.
+	 */
+	static const char* getTypeName (const std::type_info& type)
+	{
+		static std::mutex mx;
+		static std::map<std::type_index, std::string> names;
+		std::lock_guard<std::mutex> lock (mx);
+		std::map<std::type_index, std::string>::iterator it = names.find (std::type_index (type));
+		if (it == names.end())
+		{
+			std::string name = type.name();
+#if defined(__GNUG__) || defined(__clang__)
+			int status = 0;
+			char* demangled = abi::__cxa_demangle (type.name(), nullptr, nullptr, &status);
+			if (demangled && (status == 0)) name = demangled;
+			std::free (demangled);
+#endif
+			it = names.emplace (std::type_index (type), name).first;
+		}
+		return it->second.c_str();
+	}
+
+	/**
+	 *  @brief  Removes all recorded events.
+	 */
+	static void clear ()
+	{
+		Data& d = getData();
+		std::lock_guard<std::mutex> lock (d.mx);
+		d.events.clear();
+	}
+
+	/**
+	 *  @brief  Writes all recorded events to a file.
+	 *  @param filename  File name.
+	 *  @return  True on success, otherwise false.
+	 */
+	static bool write (const std::string& filename)
+	{
+		std::ofstream file (filename);
+		if (!file) return false;
+
+		Data& d = getData();
+		std::lock_guard<std::mutex> lock (d.mx);
+		file << "{\"traceEvents\":[\n";
+		for (size_t i = 0; i < d.events.size(); ++i)
+		{
+			const Event& e = d.events[i];
+			file	<< (i == 0 ? "" : ",\n")
+					<< "{\"cat\":\"" << escape (e.category)
+					<< "\",\"name\":\"" << escape (e.name)
+					<< "\",\"ph\":\"X\",\"ts\":" << std::chrono::duration_cast<std::chrono::microseconds> (e.start.time_since_epoch()).count()
+					<< ",\"dur\":" << std::chrono::duration_cast<std::chrono::microseconds> (e.end - e.start).count()
+					<< ",\"pid\":1,\"tid\":" << e.tid << "}";
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return static_cast<bool> (file);
+	}
+
+protected:
+	struct Event
+	{
+		const char* category;
+		const char* name;
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::time_point end;
+		uint32_t tid;
+	};
+
+	struct Data
+	{
+		std::mutex mx;
+		std::vector<Event> events;
+	};
+
+	static Data& getData ()
+	{
+		static Data data;
+		return data;
+	}
+
+	static uint32_t getThreadIndex ()
+	{
+		static std::atomic<uint32_t> count {0};
+		static thread_local const uint32_t index = ++count;
+		return index;
+	}
+
+	static std::string escape (const char* str)
+	{
+		std::string s;
+		for (const char* c = (str ? str : ""); *c; ++c)
+		{
+			if ((*c == '"') || (*c == '\\')) s += '\\';
+			if (static_cast<unsigned char> (*c) >= 0x20) s += *c;
+		}
+		return s;
+	}
+};
+
+}
+
+#else
+
+#define BUTILITIES_TRACE_SCOPE(category, name) ((void)0)
+
+#endif /* BUTILITIES_TRACE */
+
+#endif /* BUTILITIES_TRACE_HPP_ */
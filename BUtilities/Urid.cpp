@@ -16,60 +16,146 @@
  */
 
 #include "Urid.hpp"
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <iostream>
 
+#ifndef BUTILITIES_URID_INITIAL_CAPACITY
+#define BUTILITIES_URID_INITIAL_CAPACITY 256
+#endif
+
 namespace BUtilities 
 {
 
+Urid::Table::Table (const size_t capacity) :
+    capacity (capacity),
+    uris (new std::atomic<const Entry*>[2 * capacity]),
+    urids (new std::atomic<const Entry*>[capacity])
+{
+    for (size_t i = 0; i < 2 * capacity; ++i) uris[i].store (nullptr, std::memory_order_relaxed);
+    for (size_t i = 0; i < capacity; ++i) urids[i].store (nullptr, std::memory_order_relaxed);
+}
+
+Urid::UridMap::UridMap () :
+    table_ (nullptr),
+    tables_ (),
+    entries_ (),
+    count_ (1),
+    mx_ ()
+{
+    tables_.emplace_back (new Table (BUTILITIES_URID_INITIAL_CAPACITY));
+    entries_.emplace_back (new Entry {BUTILITIES_URID_UNKNOWN_URI, BUTILITIES_URID_UNKNOWN_URID});
+    insert (tables_.back().get(), entries_.back().get());
+    table_.store (tables_.back().get(), std::memory_order_release);
+}
+
 uint32_t Urid::add (const std::string& uri)
 {
     UridMap& uridMap = getUridMap ();
-    //mx_.lock();
-    if (uri != "") uridMap.map_[uri] = uridMap.count_;
-    else uridMap.map_[std::string (BUTILITIES_URID_ANONYMOUS_URI) + "_" + std::to_string (uridMap.count_)] = uridMap.count_;
-    //mx_.unlock();
-    return uridMap.count_++;
+    std::lock_guard<std::mutex> lock (uridMap.mx_);
+    return addLocked (uridMap, uri);
 }
 
 std::string Urid::uri (const uint32_t urid)
 {
     UridMap& uridMap = getUridMap ();
-    //mx_.lock();
-    std::string uristr = "";
-    for (std::map<std::string, uint32_t>::const_iterator it = uridMap.map_.begin(); it != uridMap.map_.end(); ++it) 
+
+    // Lock-free lookup
+    const Table* table = uridMap.table_.load (std::memory_order_acquire);
+    if (urid < table->capacity)
     {
-        if (it->second == urid)
-        {
-            uristr = it->first;
-            break;
-        }
+        const Entry* entry = table->urids[urid].load (std::memory_order_acquire);
+        if (entry) return entry->uri;
     }
-    //mx_.unlock();
-    return uristr;
+
+    // Not found: Maybe added in the meantime
+    std::lock_guard<std::mutex> lock (uridMap.mx_);
+    if (urid < uridMap.entries_.size()) return uridMap.entries_[urid]->uri;
+    return "";
 }
 
 uint32_t Urid::urid (const std::string& uri)
 {
     UridMap& uridMap = getUridMap ();
-    //mx_.lock();
-    std::map<std::string, uint32_t>::const_iterator it = uridMap.map_.find (uri);
-    if (it != uridMap.map_.end ()) 
+
+    // Lock-free lookup (may be called from multiple draw threads)
+    const Entry* entry = find (uridMap.table_.load (std::memory_order_acquire), uri);
+    if (entry) return entry->urid;
+
+    // Not found: Add exclusively, but check if another thread added it in
+    // the meantime
+    std::lock_guard<std::mutex> lock (uridMap.mx_);
+    entry = find (uridMap.table_.load (std::memory_order_relaxed), uri);
+    if (entry) return entry->urid;
+    return addLocked (uridMap, uri);
+}
+
+uint32_t Urid::addLocked (UridMap& uridMap, const std::string& uri)
+{
+    const uint32_t urid = uridMap.count_;
+    uridMap.entries_.emplace_back
+    (
+        new Entry 
+        {
+            (uri != "" ? uri : std::string (BUTILITIES_URID_ANONYMOUS_URI) + "_" + std::to_string (urid)), 
+            urid
+        }
+    );
+
+    Table* table = uridMap.tables_.back().get();
+    if (urid < table->capacity) insert (table, uridMap.entries_.back().get());
+
+    // Table full: Copy to a new table with doubled capacity and publish it.
+    // The old table is kept as it may still be read.
+    else
+    {
+        uridMap.tables_.emplace_back (new Table (2 * table->capacity));
+        table = uridMap.tables_.back().get();
+        for (const std::unique_ptr<Entry>& e : uridMap.entries_) insert (table, e.get());
+        uridMap.table_.store (table, std::memory_order_release);
+    }
+
+    return uridMap.count_++;
+}
+
+const Urid::Entry* Urid::find (const Table* table, const std::string& uri)
+{
+    // Load factor <= 0.5, thus there is always an empty slot
+    const size_t mask = 2 * table->capacity - 1;
+    for (size_t i = std::hash<std::string> () (uri) & mask; /* empty */; i = (i + 1) & mask)
     {
-        const uint32_t id = it->second;
-        //mx_.unlock();
-        return id;
+        const Entry* entry = table->uris[i].load (std::memory_order_acquire);
+        if (!entry) return nullptr;
+        if (entry->uri == uri) return entry;
     }
-    //mx_.unlock();
-    return add (uri);
+}
+
+void Urid::insert (Table* table, const Entry* entry)
+{
+    // Same URI added again: Overwrite
+    const size_t mask = 2 * table->capacity - 1;
+    for (size_t i = std::hash<std::string> () (entry->uri) & mask; /* empty */; i = (i + 1) & mask)
+    {
+        const Entry* e = table->uris[i].load (std::memory_order_relaxed);
+        if ((!e) || (e->uri == entry->uri))
+        {
+            table->uris[i].store (entry, std::memory_order_release);
+            break;
+        }
+    }
+
+    if (entry->urid < table->capacity) table->urids[entry->urid].store (entry, std::memory_order_release);
 }
 
 Urid::UridMap& Urid::getUridMap ()
 {
-    static UridMap uridMap_ = {{{BUTILITIES_URID_UNKNOWN_URI, BUTILITIES_URID_UNKNOWN_URID}}, 1};
+    static UridMap uridMap_;
     return uridMap_;
 }
 
-}
\ No newline at end of file
+}
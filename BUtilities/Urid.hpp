@@ -17,10 +17,13 @@
 #ifndef BUTILITIES_URID_HPP_
 #define BUTILITIES_URID_HPP_
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <string>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #ifndef BUTILITIES_URID_URI
 #define BUTILITIES_URID_URI "https://github.com/sjaehn/BWidgets/BUtilities/Urid.hpp"
@@ -56,14 +59,37 @@ namespace BUtilities
 class Urid
 {
 protected:
+    struct Entry
+    {
+        std::string uri;
+        uint32_t urid;
+    };
+
+    /*
+     *  Fixed size lookup table. Published tables are only extended by
+     *  atomically setting empty slots. Thus, they can be read without 
+     *  locking.
+     */
+    struct Table
+    {
+        explicit Table (const size_t capacity);
+
+        size_t capacity;
+        std::unique_ptr<std::atomic<const Entry*>[]> uris;      // Open addressed hash table, 2 * capacity
+        std::unique_ptr<std::atomic<const Entry*>[]> urids;     // Indexed by URID, capacity
+    };
+
     struct UridMap
     {
-        std::map<std::string, uint32_t> map_;
+        UridMap ();
+
+        std::atomic<const Table*> table_;
+        std::vector<std::unique_ptr<Table>> tables_;            // Incl. outgrown tables which may still be read
+        std::vector<std::unique_ptr<Entry>> entries_;
         uint32_t count_;
+        std::mutex mx_;
     };
     
-    //static std::mutex mx_;
-    
 public:
 
     Urid() = delete;
@@ -95,6 +121,31 @@ public:
 
 private:
 
+    /**
+     *  @brief  Adds an URI (if not exists before). The caller must hold
+     *  the lock.
+     *  @param uridMap  Internal URID map.
+     *  @param uri  URI.
+     *  @return  URID.
+     */
+    static uint32_t addLocked (UridMap& uridMap, const std::string& uri);
+
+    /**
+     *  @brief  Looks up an URI without locking.
+     *  @param table  Lookup table.
+     *  @param uri  URI.
+     *  @return  Pointer to the entry, or nullptr if not found.
+     */
+    static const Entry* find (const Table* table, const std::string& uri);
+
+    /**
+     *  @brief  Inserts an entry into a lookup table. The caller must hold
+     *  the lock.
+     *  @param table  Lookup table.
+     *  @param entry  Entry.
+     */
+    static void insert (Table* table, const Entry* entry);
+
     /**
      *  @brief  Get the internal (static) URID map as a reference.
      * 
@@ -72,7 +72,11 @@ cairo_surface_t* cairoplus_image_surface_clone_from_image_surface (cairo_surface
 		cairo_format_t format = cairo_image_surface_get_format (sourceSurface);
 		int width = cairo_image_surface_get_width (sourceSurface);
 		int height = cairo_image_surface_get_height (sourceSurface);
+		double sx = 1.0;
+		double sy = 1.0;
+		cairo_surface_get_device_scale (sourceSurface, &sx, &sy);
 		targetSurface = cairo_image_surface_create (format, width, height);
+		cairo_surface_set_device_scale (targetSurface, sx, sy);
 		cairo_t* cr = cairo_create (targetSurface);
 		if (targetSurface && (cairo_surface_status (targetSurface) == CAIRO_STATUS_SUCCESS))
 		{
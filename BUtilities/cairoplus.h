@@ -56,8 +56,8 @@ typedef struct {
 void cairoplus_rectangle_rounded (cairo_t* cr, double x, double y, double width, double height, double radius, uint8_t corners);
 
 /**
- *  @brief  Creates a new Cairo image surface and copies the content from a 
- *  source Cairo image surface.
+ *  @brief  Creates a new Cairo image surface and copies the content and the
+ *  device scale from a source Cairo image surface.
  *  @param sourceSurface  Source Cairo (image) surface.
  *  @return  Created new Cairo image surface.
  */
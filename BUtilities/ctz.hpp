@@ -0,0 +1,52 @@
+/* ctz.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTILITIES_CTZ_HPP_
+#define BUTILITIES_CTZ_HPP_
+
+#include <cstdint>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace BUtilities 
+{
+
+/**
+ *  @brief  Counts the trailing zero bits of a value. Thus, returns the index
+ *  of the lowest set bit.
+ *  @param value  Value. Must not be 0.
+ *  @return  Index of the lowest set bit.
+ */
+inline unsigned int ctz (const uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz (value);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward (&index, value);
+        return index;
+#else
+        unsigned int index = 0;
+        for (uint32_t v = value; !(v & 1); v >>= 1) ++index;
+        return index;
+#endif
+}
+
+}
+
+#endif /* BUTILITIES_CTZ_HPP_ */
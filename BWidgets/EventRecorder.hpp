@@ -0,0 +1,208 @@
+/* EventRecorder.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BWIDGETS_EVENTRECORDER_HPP_
+#define BWIDGETS_EVENTRECORDER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "pugl/pugl.h"
+
+#define BWIDGETS_EVENTRECORDER_MAGIC "BWEVREC1"
+
+namespace BWidgets
+{
+
+/**
+ *  @brief  Records host events to a file.
+ *
+ *  %EventRecorder writes motion, button, key, text, scroll, and configure
+ *  events (PuglEvent) together with the time since the start of the
+ *  recording to a binary file. Each record consists of the time (double),
+ *  the event type (uint32_t), the event size (uint32_t), and the raw event
+ *  data of the respective PuglEvent member (e. g., PuglMotionEvent). The
+ *  data are stored in the native byte order. Thus, recordings can only be
+ *  loaded by builds for the same platform and the same Pugl version.
+ *
+ *  Use @c Window::startRecording() to record the host events of a %Window
+ *  and EventReplay to replay them.
+ */
+class EventRecorder
+{
+public:
+
+	/**
+	 *  @brief  Recorded event.
+	 */
+	struct Entry
+	{
+		double time;		// Time since the start of the recording in seconds
+		PuglEvent event;
+	};
+
+protected:
+	std::ofstream file_;
+	std::chrono::steady_clock::time_point start_;
+
+public:
+
+	EventRecorder () = default;
+	EventRecorder (const EventRecorder& that) = delete;
+	EventRecorder& operator= (const EventRecorder& that) = delete;
+
+	~EventRecorder () {close ();}
+
+	/**
+	 *  @brief  Opens a file and starts the recording.
+	 *  @param filename  File name.
+	 *  @return  True on success, otherwise false.
+	 *
+	 *  Closes a previously opened recording first. Existing files are
+	 *  overwritten.
+	 */
+	bool open (const std::string& filename);
+
+	/**
+	 *  @brief  Ends the recording and closes the file.
+	 */
+	void close ();
+
+	/**
+	 *  @brief  Information about a running recording.
+	 *  @return  True if recording, otherwise false.
+	 */
+	bool isOpen () const;
+
+	/**
+	 *  @brief  Records an event.
+	 *  @param event  PuglEvent.
+	 *  @return  True if recorded, false if not recording or if the event
+	 *  type is not recordable.
+	 */
+	bool record (const PuglEvent& event);
+
+	/**
+	 *  @brief  Gets the size of the data stored for an event type.
+	 *  @param type  PuglEventType.
+	 *  @return  Size in bytes or 0 if the event type is not recordable.
+	 */
+	static size_t getEventSize (const PuglEventType type);
+
+	/**
+	 *  @brief  Loads a recording.
+	 *  @param filename  File name.
+	 *  @param entries  Vector to take up the recorded events.
+	 *  @return  True on success, otherwise false.
+	 *
+	 *  Entries of a file with a damaged or incompatible record are loaded up
+	 *  to this record.
+	 */
+	static bool load (const std::string& filename, std::vector<Entry>& entries);
+};
+
+inline bool EventRecorder::open (const std::string& filename)
+{
+	close ();
+	file_.open (filename, std::ios::binary | std::ios::trunc);
+	if (!file_) return false;
+
+	file_.write (BWIDGETS_EVENTRECORDER_MAGIC, sizeof (BWIDGETS_EVENTRECORDER_MAGIC) - 1);
+	start_ = std::chrono::steady_clock::now();
+	return static_cast<bool> (file_);
+}
+
+inline void EventRecorder::close ()
+{
+	if (file_.is_open()) file_.close ();
+}
+
+inline bool EventRecorder::isOpen () const
+{
+	return file_.is_open();
+}
+
+inline bool EventRecorder::record (const PuglEvent& event)
+{
+	if (!file_.is_open()) return false;
+
+	const uint32_t size = getEventSize (event.type);
+	if (size == 0) return false;
+
+	const double time = std::chrono::duration<double> (std::chrono::steady_clock::now() - start_).count();
+	const uint32_t type = event.type;
+	file_.write (reinterpret_cast<const char*> (&time), sizeof (time));
+	file_.write (reinterpret_cast<const char*> (&type), sizeof (type));
+	file_.write (reinterpret_cast<const char*> (&size), sizeof (size));
+	file_.write (reinterpret_cast<const char*> (&event), size);
+	return static_cast<bool> (file_);
+}
+
+inline size_t EventRecorder::getEventSize (const PuglEventType type)
+{
+	switch (type)
+	{
+		case PUGL_KEY_PRESS:
+		case PUGL_KEY_RELEASE:		return sizeof (PuglKeyEvent);
+		case PUGL_TEXT:				return sizeof (PuglTextEvent);
+		case PUGL_BUTTON_PRESS:
+		case PUGL_BUTTON_RELEASE:	return sizeof (PuglButtonEvent);
+		case PUGL_MOTION:			return sizeof (PuglMotionEvent);
+		case PUGL_SCROLL:			return sizeof (PuglScrollEvent);
+		case PUGL_CONFIGURE:		return sizeof (PuglConfigureEvent);
+		default:					return 0;
+	}
+}
+
+inline bool EventRecorder::load (const std::string& filename, std::vector<Entry>& entries)
+{
+	std::ifstream file (filename, std::ios::binary);
+	if (!file) return false;
+
+	char magic[sizeof (BWIDGETS_EVENTRECORDER_MAGIC) - 1];
+	if	(
+			(!file.read (magic, sizeof (magic))) ||
+			(std::memcmp (magic, BWIDGETS_EVENTRECORDER_MAGIC, sizeof (magic)) != 0)
+		) return false;
+
+	while (file.peek() != std::ifstream::traits_type::eof())
+	{
+		Entry entry {};
+		uint32_t type = 0;
+		uint32_t size = 0;
+		if	(
+				(!file.read (reinterpret_cast<char*> (&entry.time), sizeof (entry.time))) ||
+				(!file.read (reinterpret_cast<char*> (&type), sizeof (type))) ||
+				(!file.read (reinterpret_cast<char*> (&size), sizeof (size))) ||
+				(size == 0) ||
+				(size != getEventSize (static_cast<PuglEventType> (type))) ||
+				(!file.read (reinterpret_cast<char*> (&entry.event), size)) ||
+				(entry.event.type != static_cast<PuglEventType> (type))
+			) return false;
+
+		entries.push_back (entry);
+	}
+
+	return true;
+}
+
+}
+
+#endif /* BWIDGETS_EVENTRECORDER_HPP_ */
@@ -0,0 +1,156 @@
+/* EventReplay.hpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BWIDGETS_EVENTREPLAY_HPP_
+#define BWIDGETS_EVENTREPLAY_HPP_
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "Window.hpp"
+#include "EventRecorder.hpp"
+
+namespace BWidgets
+{
+
+/**
+ *  @brief  Replays recorded host events to a %Window.
+ *
+ *  %EventReplay loads a recording made by @c Window::startRecording() (see
+ *  EventRecorder) and passes the events to a %Window using
+ *  @c Window::injectEvent() . The replay doesn't depend on the wall clock.
+ *  The recorded events are grouped into frames by their time stamps and
+ *  each frame is handled immediately after the previous one. Thus, the
+ *  replay is deterministic and can be used as a performance test,
+ *  preferably with a headless %Window (see @c Window::BackendType ).
+ */
+class EventReplay
+{
+public:
+
+	/**
+	 *  @brief  Replayed frame.
+	 */
+	struct Frame
+	{
+		size_t events;	// Number of injected host events
+		double time;	// Time for the event injection and handling in seconds
+	};
+
+protected:
+	std::vector<EventRecorder::Entry> entries_;
+
+public:
+
+	EventReplay () = default;
+
+	/**
+	 *  @brief  Creates an %EventReplay and loads a recording.
+	 *  @param filename  File name.
+	 */
+	EventReplay (const std::string& filename);
+
+	/**
+	 *  @brief  Loads a recording.
+	 *  @param filename  File name.
+	 *  @return  True on success, otherwise false.
+	 *
+	 *  Replaces the previously loaded recording.
+	 */
+	bool load (const std::string& filename);
+
+	/**
+	 *  @brief  Gets the recorded events.
+	 *  @return  Vector of the recorded events.
+	 */
+	const std::vector<EventRecorder::Entry>& getEntries () const;
+
+	/**
+	 *  @brief  Replays the recorded events.
+	 *  @param window  Target %Window.
+	 *  @param frameInterval  Optional, time interval in seconds of the
+	 *  recording to be handled within a single frame or 0.0 for a single
+	 *  event per frame.
+	 *  @return  Vector of all replayed frames.
+	 *
+	 *  Injects the recorded events of each frame interval and calls
+	 *  @c Window::handleEvents() once. Frame intervals without recorded
+	 *  events are skipped. Sets the frame rate of the %Window to 0.0
+	 *  (unpaced) and the event time budget to 0.0 (unlimited) for the
+	 *  duration of the replay. Thus, each frame is completely handled and
+	 *  presented by a single call of @c Window::handleEvents() . Timers and
+	 *  animations of the %Window still use the wall clock.
+	 */
+	std::vector<Frame> play (Window& window, const double frameInterval = 1.0 / BWIDGETS_DEFAULT_FRAME_RATE) const;
+};
+
+inline EventReplay::EventReplay (const std::string& filename) :
+	EventReplay ()
+{
+	load (filename);
+}
+
+inline bool EventReplay::load (const std::string& filename)
+{
+	entries_.clear ();
+	return EventRecorder::load (filename, entries_);
+}
+
+inline const std::vector<EventRecorder::Entry>& EventReplay::getEntries () const
+{
+	return entries_;
+}
+
+inline std::vector<EventReplay::Frame> EventReplay::play (Window& window, const double frameInterval) const
+{
+	const double frameRate = window.getFrameRate ();
+	const double eventTimeBudget = window.getEventTimeBudget ();
+	window.setFrameRate (0.0);
+	window.setEventTimeBudget (0.0);
+
+	std::vector<Frame> frames;
+	size_t i = 0;
+	while (i < entries_.size())
+	{
+		const double end =	(
+								frameInterval > 0.0 ?
+								(std::floor (entries_[i].time / frameInterval) + 1.0) * frameInterval :
+								entries_[i].time
+							);
+
+		Frame frame {0, 0.0};
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while ((i < entries_.size()) && ((frame.events == 0) || (entries_[i].time < end)))
+		{
+			window.injectEvent (entries_[i].event);
+			++frame.events;
+			++i;
+		}
+		window.handleEvents ();
+		frame.time = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+		frames.push_back (frame);
+	}
+
+	window.setFrameRate (frameRate);
+	window.setEventTimeBudget (eventTimeBudget);
+	return frames;
+}
+
+}
+
+#endif /* BWIDGETS_EVENTREPLAY_HPP_ */
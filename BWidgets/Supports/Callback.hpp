@@ -18,10 +18,11 @@
 #ifndef BWIDGETS_CALLBACK_HPP_
 #define BWIDGETS_CALLBACK_HPP_
 
+#include <array>
 #include <cstdint>
-#include <map>
 #include <functional>
 #include "../../BEvents/Event.hpp"
+#include "../../BUtilities/ctz.hpp"
 
 namespace BWidgets
 {
@@ -30,9 +31,18 @@ namespace BWidgets
  *  @brief  Callback functionality
  *
  *  The %Callback class provides callback functionality for EventTypes.
+ *  The callback functions are stored in a fixed array indexed by the event
+ *  type bit. A bitmask of the defined callback functions allows a lookup
+ *  without any search.
  */
-class Callback : protected std::map<uint8_t, std::function<void (BEvents::Event*)>>
+class Callback
 {
+protected:
+    static constexpr size_t nrCallbacks = 16;
+
+    std::array<std::function<void (BEvents::Event*)>, nrCallbacks> callbacks_;
+    uint32_t callbackMask_ = 0;
+
 public:
 
     /**
@@ -59,9 +69,13 @@ public:
 	 */
 	void setCallbackFunction (const BEvents::Event::EventType eventType, const std::function<void (BEvents::Event*)>& callbackFunction)
     {
-        for (uint32_t i = 0; i < 32; ++i)
+        for (uint32_t i = 0; i < nrCallbacks; ++i)
         {
-            if ((1 << i) & static_cast<uint32_t>(eventType)) operator[] (i) = callbackFunction;
+            if ((1 << i) & static_cast<uint32_t>(eventType)) 
+            {
+                callbacks_[i] = callbackFunction;
+                callbackMask_ |= (1 << i);
+            }
         }
     }
 
@@ -71,12 +85,12 @@ public:
 	 */
     void removeCallbackFunction (const BEvents::Event::EventType eventType)
     {
-        for (uint32_t i = 0; i < 32; ++i)
+        for (uint32_t i = 0; i < nrCallbacks; ++i)
         {
             if ((1 << i) & static_cast<uint32_t>(eventType))
             {
-                const_iterator cit = find (i);
-                if (cit != end()) erase (cit);
+                callbacks_[i] = nullptr;
+                callbackMask_ &= ~(1 << i);
             } 
         }
     }
@@ -88,17 +102,13 @@ public:
      *  If multiple event types are passed, then only the callback function
      *  for the first match is returned.
 	 */
-    std::function<void (BEvents::Event*)> callback (const BEvents::Event::EventType eventType) 
+    const std::function<void (BEvents::Event*)>& callback (const BEvents::Event::EventType eventType) const
     {
-        for (uint32_t i = 0; i < 32; ++i)
-        {
-            if ((1 << i) & static_cast<uint32_t>(eventType))
-            {
-                if (find(i) != end()) return operator[] (i);
-            } 
-        }
+        const uint32_t match = callbackMask_ & static_cast<uint32_t>(eventType);
+        if (match) return callbacks_[BUtilities::ctz (match)];
         
-        return defaultCallback;
+        static const std::function<void (BEvents::Event*)> defaultFunction = defaultCallback;
+        return defaultFunction;
     }
 
     /**
@@ -18,8 +18,8 @@
 #ifndef BWIDGETS_EVENTQUEUEABLE_HPP_
 #define BWIDGETS_EVENTQUEUEABLE_HPP_
 
-#include <algorithm>
-#include <list>
+#include <cstddef>
+#include <cstdint>
 #include "../../BEvents/Event.hpp"
 
 namespace BWidgets
@@ -30,13 +30,33 @@ namespace BWidgets
  *
  *  Parent class of the (main) BWidgets::Window event queue. By default, all
  *  events are able to be queued to the event queue.
+ *
+ *  The event queue is an intrusive doubly linked list of the queued events.
+ *  Thus, adding, popping, and removing events as well as testing if an event
+ *  is queued take constant time and don't allocate memory.
+ *
+ *  The events are queued by their priority (see @c getEventPriority() ):
+ *  Input events before value changed, message, and close request events
+ *  before configure request events before expose request events. Events of
+ *  the same priority keep their order.
  */
 class EventQueueable
 {
 
 protected:
+    enum EventPriority : size_t
+    {
+        inputPriority       = 0,
+        valuePriority       = 1,
+        configurePriority   = 2,
+        exposePriority      = 3,
+        nrEventPriorities   = 4
+    };
+
     BEvents::Event::EventType eventQueueable_;
-    std::list<BEvents::Event*> eventQueue_;
+    BEvents::Event* eventQueueFront_;
+    BEvents::Event* eventQueueBack_[nrEventPriorities];
+    size_t eventQueueSize_;
     
 public:
 
@@ -47,6 +67,9 @@ public:
      */
     EventQueueable ();
 
+    EventQueueable (const EventQueueable& that) = delete;
+    EventQueueable& operator= (const EventQueueable& that) = delete;
+
     virtual ~EventQueueable();
 
     /**
@@ -84,8 +107,8 @@ public:
     /**
      *  @brief  Pops the event from the front of the event queue.
      * 
-     *  @return  Pointer to the event beeing in front of the event queue or
-     *  nullptr if empty.
+     *  @return  Pointer to the event beeing in front of the event queue 
+     *  (the oldest event of the highest priority) or nullptr if empty.
      */
     virtual BEvents::Event* popEvent ();
 
@@ -103,19 +126,65 @@ public:
      */
     virtual void deleteEvent (BEvents::Event* event);
 
+    /**
+     *  @brief  Tests if an event is queued in this event queue.
+     *  @param event  Pointer to the event.
+     *  @return  True if queued, otherwise false.
+     */
+    bool isEventQueued (const BEvents::Event* event) const;
+
+    /**
+     *  @brief  Tests if the event queue is empty.
+     *  @return  True if empty, otherwise false.
+     */
+    bool isEventQueueEmpty () const;
+
+    /**
+     *  @brief  Gets the number of queued events.
+     *  @return  Number of events.
+     */
+    size_t getEventQueueSize () const;
+
+protected:
+    /**
+     *  @brief  Gets the first event of the event queue.
+     *  @return  Pointer to the event or nullptr if empty.
+     */
+    BEvents::Event* getFirstQueuedEvent () const;
+
+    /**
+     *  @brief  Gets the event following a queued event.
+     *  @param event  Pointer to a queued event.
+     *  @return  Pointer to the next event or nullptr if @a event is the
+     *  last event.
+     */
+    static BEvents::Event* getNextQueuedEvent (const BEvents::Event* event);
+
+    /**
+     *  @brief  Gets the queue priority of an event.
+     *  @param event  Pointer to the event.
+     *  @return  Priority. Lower values are handled first.
+     */
+    static EventPriority getEventPriority (const BEvents::Event* event);
+
+private:
+    void unlinkEvent (BEvents::Event* event);
+
 };
 
 inline EventQueueable::EventQueueable() :
     eventQueueable_(BEvents::Event::EventType::all),
-    eventQueue_()
+    eventQueueFront_(nullptr),
+    eventQueueBack_{nullptr, nullptr, nullptr, nullptr},
+    eventQueueSize_(0)
 {}
 
 inline EventQueueable::~EventQueueable()
 {
-    while (!eventQueue_.empty())
+    while (eventQueueFront_)
     {
-        BEvents::Event* event = eventQueue_.front();
-        eventQueue_.pop_front();
+        BEvents::Event* event = eventQueueFront_;
+        unlinkEvent (event);
         delete event;
     }
 }
@@ -137,7 +206,28 @@ inline void EventQueueable::addEventToQueue (BEvents::Event* event)
     // Add to the event queue
     if (isEventQueueable (event->getEventType()))
     {
-        if (std::find (eventQueue_.begin(), eventQueue_.end(), event) ==  eventQueue_.end()) eventQueue_.push_back (event);
+        if (event->queue_) return;  // Already queued
+
+        // Insert behind the last event of the same or a higher priority
+        const size_t priority = getEventPriority (event);
+        BEvents::Event* prev = nullptr;
+        for (size_t p = priority + 1; p > 0; --p)
+        {
+            if (eventQueueBack_[p - 1])
+            {
+                prev = eventQueueBack_[p - 1];
+                break;
+            }
+        }
+
+        event->queue_ = this;
+        event->queuePrev_ = prev;
+        event->queueNext_ = (prev ? prev->queueNext_ : eventQueueFront_);
+        if (event->queueNext_) event->queueNext_->queuePrev_ = event;
+        if (prev) prev->queueNext_ = event;
+        else eventQueueFront_ = event;
+        eventQueueBack_[priority] = event;
+        ++eventQueueSize_;
     }
 
     // Not queueable: discard event
@@ -146,21 +236,16 @@ inline void EventQueueable::addEventToQueue (BEvents::Event* event)
 
 inline BEvents::Event* EventQueueable::popEvent ()
 {
-    BEvents::Event* event = eventQueue_.front();
-    eventQueue_.pop_front();
+    BEvents::Event* event = eventQueueFront_;
+    if (event) unlinkEvent (event);
     return event;
 }
 
 inline BEvents::Event* EventQueueable::popEvent (BEvents::Event* event)
 {
-    std::list<BEvents::Event*>::const_iterator it = std::find (eventQueue_.begin(), eventQueue_.end(), event);
-    if (it == eventQueue_.cend()) return nullptr;
-    else
-    {
-        BEvents::Event* e = *it;
-        eventQueue_.erase (it);
-        return e;
-    }
+    if (!isEventQueued (event)) return nullptr;
+    unlinkEvent (event);
+    return event;
 }
 
 inline void EventQueueable::deleteEvent (BEvents::Event* event)
@@ -169,5 +254,65 @@ inline void EventQueueable::deleteEvent (BEvents::Event* event)
     delete event;
 }
 
+inline bool EventQueueable::isEventQueued (const BEvents::Event* event) const
+{
+    return event && (event->queue_ == this);
+}
+
+inline bool EventQueueable::isEventQueueEmpty () const
+{
+    return (eventQueueFront_ == nullptr);
+}
+
+inline size_t EventQueueable::getEventQueueSize () const
+{
+    return eventQueueSize_;
+}
+
+inline BEvents::Event* EventQueueable::getFirstQueuedEvent () const
+{
+    return eventQueueFront_;
+}
+
+inline BEvents::Event* EventQueueable::getNextQueuedEvent (const BEvents::Event* event)
+{
+    return (event ? event->queueNext_ : nullptr);
+}
+
+inline EventQueueable::EventPriority EventQueueable::getEventPriority (const BEvents::Event* event)
+{
+    const uint32_t eventType = static_cast<uint32_t>(event->getEventType());
+    if (eventType & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) return exposePriority;
+    if (eventType & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) return configurePriority;
+    if 
+    (
+        eventType & 
+        (
+            static_cast<uint32_t>(BEvents::Event::EventType::valueChangedEvent) |
+            static_cast<uint32_t>(BEvents::Event::EventType::messageEvent) |
+            static_cast<uint32_t>(BEvents::Event::EventType::closeRequestEvent)
+        )
+    ) return valuePriority;
+    return inputPriority;
+}
+
+inline void EventQueueable::unlinkEvent (BEvents::Event* event)
+{
+    const size_t priority = getEventPriority (event);
+    if (eventQueueBack_[priority] == event)
+    {
+        BEvents::Event* prev = event->queuePrev_;
+        eventQueueBack_[priority] = ((prev && (getEventPriority (prev) == priority)) ? prev : nullptr);
+    }
+
+    if (event->queuePrev_) event->queuePrev_->queueNext_ = event->queueNext_;
+    else eventQueueFront_ = event->queueNext_;
+    if (event->queueNext_) event->queueNext_->queuePrev_ = event->queuePrev_;
+    event->queue_ = nullptr;
+    event->queuePrev_ = nullptr;
+    event->queueNext_ = nullptr;
+    --eventQueueSize_;
+}
+
 }
-#endif /* BWIDGETS_EVENTQUEUEABLE_HPP_ */
\ No newline at end of file
+#endif /* BWIDGETS_EVENTQUEUEABLE_HPP_ */
@@ -18,6 +18,7 @@
 #ifndef BWIDGETS_VALUEABLETYPED_HPP_
 #define BWIDGETS_VALUEABLETYPED_HPP_
 
+#include <typeinfo>
 #include "Valueable.hpp"
 #include "ValueTransferable.hpp"
 #include "Validatable.hpp"
@@ -37,6 +38,26 @@ class ValueableTyped : public Valueable
 protected:
     T value_;
 
+    struct Resolved
+    {
+        const ValueableTyped<T>* owner;
+        const std::type_info* type;
+        Widget* widget;
+        Validatable<T>* validatable;
+    };
+
+    Resolved resolved_;
+
+    /**
+     *  @brief  Gets the Widget and the Validatable<T> of this object.
+     *  (Re-)Resolves them if not yet done for this object and its dynamic
+     *  type.
+     *
+     *  Copies are detected by their owner. Objects under construction are
+     *  detected by their (still changing) dynamic type.
+     */
+    const Resolved& getResolved ();
+
 public:
 
     typedef T value_type;
@@ -94,7 +115,8 @@ ValueableTyped<T>::ValueableTyped () :
 template<class T>
 ValueableTyped<T>::ValueableTyped (const T& value) :
     Valueable (),
-    value_ (value)
+    value_ (value),
+    resolved_ {nullptr, nullptr, nullptr, nullptr}
 {
 
 }
@@ -109,7 +131,7 @@ template<class T>
 void ValueableTyped<T>::setValue (const T& value)
 {
     // Validate
-    Validatable<T>* validatable = dynamic_cast<Validatable<T>*>(this);
+    Validatable<T>* validatable = getResolved().validatable;
     T nval = (validatable && validatable->isValidatable() ? validatable->validate (value) : value);
 
     // Set new value_
@@ -117,7 +139,8 @@ void ValueableTyped<T>::setValue (const T& value)
     {
         value_ = nval;
         if (isValueable()) emitValueChanged();
-        if (dynamic_cast<Widget*>(this)) dynamic_cast<Widget*>(this)->update();
+        Widget* thisWidget = getResolved().widget;
+        if (thisWidget) thisWidget->update();
     }
 }
 
@@ -130,7 +153,7 @@ T ValueableTyped<T>::getValue () const
 template<class T>
 void ValueableTyped<T>::emitValueChanged ()
 {
-    Widget* thisWidget = dynamic_cast<Widget*>(this);
+    Widget* thisWidget = getResolved().widget;
     if (!thisWidget) return;
     
     if (thisWidget->getMainWindow())
@@ -140,5 +163,20 @@ void ValueableTyped<T>::emitValueChanged ()
 	}
 }
 
+template<class T>
+const typename ValueableTyped<T>::Resolved& ValueableTyped<T>::getResolved ()
+{
+    const std::type_info* type = &typeid (*this);
+    if ((resolved_.owner != this) || (resolved_.type != type))
+    {
+        resolved_.owner = this;
+        resolved_.type = type;
+        resolved_.widget = dynamic_cast<Widget*>(this);
+        resolved_.validatable = dynamic_cast<Validatable<T>*>(this);
+    }
+
+    return resolved_;
+}
+
 }
 #endif /* BWIDGETS_VALUEABLETYPED_HPP_ */
\ No newline at end of file
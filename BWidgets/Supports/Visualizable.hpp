@@ -19,6 +19,7 @@
 #define BWIDGETS_VISUALIZABLE_HPP_
 
 #include <cairo/cairo.h>
+#include <cmath>
 #include <limits>
 #include "../../BUtilities/cairoplus.h"
 #include "../../BUtilities/Area.hpp"
@@ -49,6 +50,13 @@ namespace BWidgets
  *
  *  If the main window (then) receives a host system expose event, the
  *  main window updates the visual content covered by this event.
+ *
+ *  Optionally, a %Visualizable object can be set to retained mode (see
+ *  @c setRetained() ). In retained mode, @c draw() records the draw 
+ *  operations into a Cairo recording surface instead of the RGBA surface.
+ *  This recording is then rasterized to the RGBA surface at the scale
+ *  required by the main window (e.g., its zoom factor). Thus, changing the 
+ *  zoom only replays the recording and doesn't call @c draw() again.
  */
 class Visualizable : virtual public Callback, public Support
 {
@@ -62,6 +70,9 @@ protected:
     bool scheduleDraw_;
     BUtilities::Point<> extends_;
     Surface surface_;
+    cairo_surface_t* recording_;
+    bool scheduleRasterize_;
+    bool concurrentDrawable_;
     int layer_;
 
 public:
@@ -219,6 +230,45 @@ public:
      */
     virtual int getLayer () const;
 
+    /**
+     *  @brief  Switches retained mode on/off.
+     *  @param status  True if on, otherwise false.
+     *
+     *  In retained mode, @c draw() records into a Cairo recording surface
+     *  which is rasterized at the display scale on demand. A full draw 
+     *  starts a new recording, a partial draw is added to the recording.
+     *  Switching the retained mode calls @c update() .
+     *
+     *  The display scale only differs from 1.0 if the main Window uses 
+     *  zoomed surfaces (see @c Window::setZoomedSurfaces() ). Thus, retained
+     *  mode only pays off together with zoomed surfaces.
+     */
+    virtual void setRetained (const bool status);
+
+    /**
+     *  @brief  Information about the retained mode.
+     *  @return  True if on, otherwise false.
+     */
+    bool isRetained () const;
+
+    /**
+     *  @brief  Switches concurrent drawing on/off.
+     *  @param status  True if on (default), otherwise false.
+     *
+     *  If the main window draws in parallel (see 
+     *  @c Window::setParallelDraw() ), objects which are concurrent 
+     *  drawable may be drawn on a worker thread. Switch it off for objects
+     *  with a @c draw() method which is not thread-safe (e.g., if it 
+     *  changes other objects or emits events).
+     */
+    virtual void setConcurrentDrawable (const bool status);
+
+    /**
+     *  @brief  Information about concurrent drawing.
+     *  @return  True if on, otherwise false.
+     */
+    bool isConcurrentDrawable () const;
+
     /**
      *  @brief  Method to be called following an object state change.
      *
@@ -241,6 +291,9 @@ public:
     /**
      *  @brief  Access to the Cairo surface.
      *  @return  Pointer to the Cairo surface.
+     *
+     *  Returns the Cairo recording surface in retained mode. Otherwise, it
+     *  returns the RGBA surface.
      */
     cairo_surface_t* cairoSurface() const;
 
@@ -266,6 +319,18 @@ public:
 
 protected:
 
+    /**
+     *  @brief  Rasterizes the recording surface (retained mode only).
+     *  @param scale  Scale (e.g., zoom factor) of the RGBA surface.
+     *  @return  Pointer to the RGBA surface.
+     *
+     *  Replays the recording surface onto the RGBA surface if the recording
+     *  changed or if the RGBA surface has got another scale. The RGBA 
+     *  surface keeps the user space extends of the object. Outside of the
+     *  retained mode, the RGBA surface is returned unchanged.
+     */
+    cairo_surface_t* rasterize (const double scale);
+
     /**
      *  @brief  Unclipped draw to the surface (if is visualizable).
      *
@@ -312,6 +377,9 @@ inline Visualizable::Visualizable (const BUtilities::Point<> extends) :
     scheduleDraw_ (true),
     extends_ (extends),
     surface_ {cairo_image_surface_create (CAIRO_FORMAT_ARGB32, extends.x, extends.y), 1.0},
+    recording_ (nullptr),
+    scheduleRasterize_ (false),
+    concurrentDrawable_ (true),
     layer_ (0)
 {
 
@@ -323,14 +391,22 @@ inline Visualizable::Visualizable (const Visualizable& that) :
     scheduleDraw_ (that.scheduleDraw_),
     extends_ (that.extends_),
     surface_ {cairoplus_image_surface_clone_from_image_surface (that.surface_.surface), that.surface_.scale},
+    recording_ (nullptr),
+    scheduleRasterize_ (false),
+    concurrentDrawable_ (that.concurrentDrawable_),
     layer_ (that.layer_)
 {
-
+    if (that.recording_) 
+    {
+        recording_ = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+        scheduleDraw_ = true;
+    }
 }
 
 inline Visualizable::~Visualizable ()
 {
     cairo_surface_destroy (surface_.surface);
+    if (recording_) cairo_surface_destroy (recording_);
 }
 
 inline Visualizable& Visualizable::operator= (const Visualizable& that)
@@ -342,6 +418,10 @@ inline Visualizable& Visualizable::operator= (const Visualizable& that)
     if (surface_.surface) cairo_surface_destroy (surface_.surface);
     surface_.surface = cairoplus_image_surface_clone_from_image_surface (that.surface_.surface);
     surface_.scale = that.surface_.scale;
+    if (recording_) cairo_surface_destroy (recording_);
+    recording_ = (that.recording_ ? cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, nullptr) : nullptr);
+    scheduleRasterize_ = false;
+    concurrentDrawable_ = that.concurrentDrawable_;
     layer_ = that.layer_;
 
     update();
@@ -427,7 +507,10 @@ inline void Visualizable::resize (const BUtilities::Point<> extends)
         extends_ = BUtilities::Point<> (std::max (extends.x, 0.0), std::max (extends.y, 0.0));
 
         // Create new surface
-        cairo_surface_t* new_surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, extends_.x, extends_.y);
+        cairo_surface_t* new_surface = cairo_image_surface_create   (CAIRO_FORMAT_ARGB32, 
+                                                                     std::ceil (extends_.x * surface_.scale), 
+                                                                     std::ceil (extends_.y * surface_.scale));
+        cairo_surface_set_device_scale (new_surface, surface_.scale, surface_.scale);
 
         // Copy surface
 		if (new_surface && (cairo_surface_status (new_surface) == CAIRO_STATUS_SUCCESS))
@@ -435,14 +518,14 @@ inline void Visualizable::resize (const BUtilities::Point<> extends)
             cairo_t* cr = cairo_create (new_surface);
 			if (cr && (cairo_status (cr) == CAIRO_STATUS_SUCCESS))
 			{
-				cairo_set_source_surface (cr, cairoSurface(), 0, 0);
+				cairo_set_source_surface (cr, surface_.surface, 0, 0);
 				cairo_paint (cr);
 				cairo_destroy (cr);
 			}
 		}
 
         // Delete old surface
-        cairo_surface_destroy (cairoSurface());
+        cairo_surface_destroy (surface_.surface);
 
         // Copy new surface pointer
         surface_.surface = new_surface;
@@ -456,6 +539,43 @@ inline BUtilities::Point<> Visualizable::getExtends () const
     return extends_;
 }
 
+inline void Visualizable::setRetained (const bool status)
+{
+    if (status == isRetained()) return;
+
+    if (status) recording_ = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+    else
+    {
+        cairo_surface_destroy (recording_);
+        recording_ = nullptr;
+
+        // Back to unscaled rasterization
+        if (surface_.scale != 1.0)
+        {
+            cairo_surface_destroy (surface_.surface);
+            surface_.surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, extends_.x, extends_.y);
+            surface_.scale = 1.0;
+        }
+    }
+
+    update();
+}
+
+inline bool Visualizable::isRetained () const
+{
+    return (recording_ != nullptr);
+}
+
+inline void Visualizable::setConcurrentDrawable (const bool status)
+{
+    concurrentDrawable_ = status;
+}
+
+inline bool Visualizable::isConcurrentDrawable () const
+{
+    return concurrentDrawable_;
+}
+
 inline void Visualizable::update ()
 {
     scheduleDraw_ = true;
@@ -464,6 +584,33 @@ inline void Visualizable::update ()
 
 inline cairo_surface_t* Visualizable::cairoSurface() const
 {
+    return (recording_ ? recording_ : surface_.surface);
+}
+
+inline cairo_surface_t* Visualizable::rasterize (const double scale)
+{
+    if ((!recording_) || ((!scheduleRasterize_) && (scale == surface_.scale))) return surface_.surface;
+
+    // Re-create RGBA surface with the new scale
+    if (scale != surface_.scale)
+    {
+        cairo_surface_destroy (surface_.surface);
+        surface_.surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, std::ceil (extends_.x * scale), std::ceil (extends_.y * scale));
+        cairo_surface_set_device_scale (surface_.surface, scale, scale);
+        surface_.scale = scale;
+    }
+
+    // Replay
+    cairoplus_surface_clear (surface_.surface);
+    cairo_t* cr = cairo_create (surface_.surface);
+    if (cr && (cairo_status (cr) == CAIRO_STATUS_SUCCESS))
+    {
+        cairo_set_source_surface (cr, recording_, 0.0, 0.0);
+        cairo_paint (cr);
+    }
+    cairo_destroy (cr);
+
+    scheduleRasterize_ = false;
     return surface_.surface;
 }
 
@@ -489,6 +636,18 @@ inline void Visualizable::draw (const double x0, const double y0, const double w
 
 inline void Visualizable::draw (const BUtilities::Area<>& area)
 {
+    // Retained mode: Start a new recording for a full draw. Partial draws
+    // are clipped to the area and appended to the existing recording.
+    if (recording_)
+    {
+        if (area.includes (BUtilities::Area<> (0.0, 0.0, extends_.x, extends_.y)))
+        {
+            cairo_surface_destroy (recording_);
+            recording_ = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+        }
+        scheduleRasterize_ = true;
+    }
+
     scheduleDraw_ = false;
 }
 }
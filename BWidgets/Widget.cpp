@@ -18,20 +18,31 @@
 
 #include "Widget.hpp"
 #include "Supports/Activatable.hpp"
+#include "Supports/Clickable.hpp"
+#include "Supports/Closeable.hpp"
+#include "Supports/Draggable.hpp"
 #include "Supports/Enterable.hpp"
 #include "Supports/EventPassable.hpp"
+#include "Supports/KeyPressable.hpp"
+#include "Supports/Messagable.hpp"
 #include "Supports/PointerFocusable.hpp"
 #include "Supports/Linkable.hpp"
 #include "Supports/Pointable.hpp"
+#include "Supports/Scrollable.hpp"
+#include "Supports/Valueable.hpp"
 #include "Supports/Visualizable.hpp"
 #include "Window.hpp"
 #include "Label.hpp"
 #include "../BEvents/ExposeEvent.hpp"
 #include "../BEvents/PointerFocusEvent.hpp"
+#include "../BUtilities/Trace.hpp"
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <string>
+#include <typeinfo>
 
 namespace BWidgets
 {
@@ -58,7 +69,12 @@ Widget::Widget (const double x, const double y, const double width, const double
 	focus_ (title == "" ? nullptr : new (std::nothrow) Label (title, BUtilities::Urid::urid (BUtilities::Urid::uri (urid) + "/focus"), "")),
 	focusTextFunction_([](const Widget* widget) {return (widget ? widget->getTitle() : "");}),
 	pushStyle_ (true),
-	devices_()
+	devices_(),
+	geometryCache_ {0, BUtilities::Point<> (), false, BWIDGETS_UNDEFINED_LAYER, false, BUtilities::Area<> ()},
+	queuedEventsFront_ (nullptr),
+	queuedEventsBack_ (nullptr),
+	requestEventsFront_ (nullptr),
+	supportTable_ {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}
 {
 	if (focus_) 
 	{
@@ -72,9 +88,8 @@ Widget::Widget (const double x, const double y, const double width, const double
 
 Widget::~Widget ()
 {
-	// Delete all grapped devices
-	for (const BDevices::Device* d : devices_) delete d;
-	devices_.clear();
+	// Free all grapped devices
+	Widget::freeDevice();
 
 	// Release from parent (and main) if still linked
 	if (parent_) parent_->release (this);
@@ -94,6 +109,7 @@ Widget* Widget::clone () const
 
 void Widget::copy (const Widget* that)
 {
+	invalidateGeometry();
 	Visualizable::operator= (*that);
 	EventMergeable::operator= (*that);
 	EventPassable::operator= (*that);
@@ -102,6 +118,7 @@ void Widget::copy (const Widget* that)
 	Enterable::operator= (*that);
 	position_ = that->position_;
 	stacking_ = that->stacking_;
+	invalidateGeometry();
 	status_ = that->status_;
 	title_ = that->title_;
 	style_ = that->style_;
@@ -166,6 +183,7 @@ std::list<Linkable*>::iterator Widget::add (Linkable* child, std::function<void
 	Widget* childWidget = dynamic_cast<Widget*> (child);
 	if (!childWidget) return children_.end();
 
+	childWidget->invalidateGeometry();
 	std::list<Linkable*>::iterator it = Linkable::add 
 	(
 		child,
@@ -173,11 +191,22 @@ std::list<Linkable*>::iterator Widget::add (Linkable* child, std::function<void
 		{
 			Widget* w = dynamic_cast<Widget*>(l);
 			addfunc (l);
-			if (w) w->update ();
+			if (w)
+			{
+				// Register devices grabbed before linking
+				Window* window = w->getMainWindow();
+				if (window)
+				{
+					for (const std::unique_ptr<BDevices::Device>& d : w->devices_) window->addDeviceGrab (w, *d);
+				}
+
+				w->update ();
+			}
 
 			// TODO Stacking
 		}
 	);
+	childWidget->invalidateGeometry();
 
 	if (pushStyle_)
 	{
@@ -227,6 +256,7 @@ void Widget::release (Linkable* child, std::function<void (Linkable* obj)> relea
 
 	bool wasVisible = childWidget->isVisible ();
 	childWidget->hide();
+	childWidget->invalidateGeometry();
 	Linkable::release
 	(
 		child,
@@ -238,12 +268,14 @@ void Widget::release (Linkable* child, std::function<void (Linkable* obj)> relea
 			if (w && w->getMainWindow())
 			{
 				w->getMainWindow()->purgeEventQueue (w);
+				w->getMainWindow()->purgeCrossThreadItems (w);
 				w->main_ = nullptr;
 				releasefunc (l);
 			}
 			return true;
 		}
 	);
+	childWidget->invalidateGeometry();
 
 	if (wasVisible) 
 	{
@@ -254,46 +286,54 @@ void Widget::release (Linkable* child, std::function<void (Linkable* obj)> relea
 
 void Widget::grabDevice (const BDevices::Device &device)
 {
-	devices_.insert(device.clone());
+	for (std::unique_ptr<BDevices::Device>& d : devices_)
+	{
+		if (*d == device)
+		{
+			d.reset (device.clone());
+			return;
+		}
+	}
+
+	devices_.emplace_back (device.clone());
+	Window* window = getMainWindow();
+	if (window && (window != this)) window->addDeviceGrab (this, device);
 }
 
 void Widget::freeDevice ()
 {
-	for (BDevices::Device* d : devices_) delete d;
+	Window* window = getMainWindow();
+	if (window && (window != this))
+	{
+		for (const std::unique_ptr<BDevices::Device>& d : devices_) window->removeDeviceGrab (this, *d);
+	}
 	devices_.clear();
 }
 
 void Widget::freeDevice (const BDevices::Device &device)
 {
-	for (std::set<BDevices::Device*>::iterator it = devices_.begin(); it != devices_.end(); /* empty */)
+	for (std::vector<std::unique_ptr<BDevices::Device>>::iterator it = devices_.begin(); it != devices_.end(); ++it)
 	{
-		std::set<BDevices::Device*>::iterator nit = std::next(it);
-		BDevices::Device* d = *it;
-		if (*d == device)
+		if (**it == device)
 		{
-			delete d;
+			Window* window = getMainWindow();
+			if (window && (window != this)) window->removeDeviceGrab (this, device);
 			devices_.erase (it);
+			return;
 		}
-
-		it = nit;
 	}
 }
 
 bool Widget::isDeviceGrabbed (const BDevices::Device& device) const
 {
-	for (BDevices::Device* d : devices_)
-	{
-		if (*d == device) return true;
-	}
-
-	return false;
+	return (getDevice (device) != nullptr);
 }
 
 BDevices::Device* Widget::getDevice (const BDevices::Device& device) const
 {
-	for (BDevices::Device* d : devices_)
+	for (const std::unique_ptr<BDevices::Device>& d : devices_)
 	{
-		if (*d == device) return d;
+		if (*d == device) return d.get();
 	}
 
 	return nullptr;
@@ -310,6 +350,7 @@ void Widget::raise ()
 		if (*it == this)
 		{
 			std::swap (*it, *(std::next (it)));
+			invalidateHitIndex();
 			Widget* parentWidget = getParentWidget();
 			if (parentWidget && parentWidget->isVisible ()) parentWidget->emitExposeEvent ();
 			break;
@@ -328,6 +369,7 @@ void Widget::drop ()
 		if (*it == this)
 		{
 			std::swap (*it, *(std::prev (it)));
+			invalidateHitIndex();
 			Widget* parentWidget = getParentWidget();
 			if (parentWidget && parentWidget->isVisible ()) parentWidget->emitExposeEvent ();
 			break;
@@ -345,6 +387,7 @@ void Widget::dropToBack ()
 	{
 		getParent()->getChildren().erase (it);
 		getParent()->getChildren().push_front (this);
+		invalidateHitIndex();
 		Widget* parentWidget = getParentWidget();
 		if (parentWidget && parentWidget->isVisible ()) parentWidget->emitExposeEvent ();
 	}
@@ -360,6 +403,7 @@ void Widget::raiseToFront ()
 	{
 		getParent()->getChildren().erase (it);
 		getParent()->getChildren().push_back (this);
+		invalidateHitIndex();
 		Widget* parentWidget = getParentWidget();
 		if (parentWidget && parentWidget->isVisible ()) parentWidget->emitExposeEvent ();
 	}
@@ -377,6 +421,7 @@ void Widget::show()
 	if (isVisualizable()) return;
 
 	Visualizable::setSupport (true);
+	invalidateGeometry();
 
 	if (isVisible ())
 	{
@@ -398,8 +443,9 @@ void Widget::hide()
 	bool wasVisible = isVisible ();
 
 	// Get area occupied by this widget and its children
-	BUtilities::Area<> hideArea = getAbsoluteFamilyArea ([] (const Widget* w) {return w->isVisible();});
+	BUtilities::Area<> hideArea = getVisibleAbsoluteFamilyArea ();
 	Visualizable::setSupport (false);
+	invalidateGeometry();
 
 	if (wasVisible && (this != dynamic_cast<Widget*> (getMainWindow())))
 	{
@@ -418,21 +464,28 @@ void Widget::hide()
 
 bool Widget::isVisible() const
 {
-	// Go backwards in widget tree until nullptr
-	for (const Widget* w = this; w; w = w->getParentWidget())			
+	GeometryCache& cache = getGeometryCache();
+	if (!(cache.flags & visibleCached))
 	{
-		// widget invisible? -> break as invisible
-		if (!w->isVisualizable()) return false;
-
-		// main reached ? -> visible
-		if (w == dynamic_cast<Widget*>(getMainWindow())) return true;
+		// Visible if visualizable and either the main window or linked to
+		// the main window by visible parents
+		bool visible = false;
+		if (isVisualizable())
+		{
+			Window* main = getMainWindow();
+			if (this == dynamic_cast<const Widget*>(main)) visible = true;
+			else if (main)
+			{
+				const Widget* p = getParentWidget();
+				visible = (p && p->isVisible());
+			}
+		}
 
-		// no main window -> break as invisible;
-		if  (!w->getMainWindow()) return false;
+		cache.visible = visible;
+		cache.flags |= visibleCached;
 	}
 
-	// nullptr reached ? -> not connected to main -> invisible
-	return false;						
+	return cache.visible;
 }
 
 void Widget::update()
@@ -467,7 +520,12 @@ void Widget::resize (const double width, const double height)
 
 void Widget::resize (const BUtilities::Point<> extends)
 {
-	Visualizable::resize (extends);
+	if ((extends.x != getWidth()) || (extends.y != getHeight()))
+	{
+		invalidateGeometry();
+		Visualizable::resize (extends);
+		invalidateGeometry();
+	}
 }
 
 void Widget::moveTo (const double x, const double y) {moveTo (BUtilities::Point<> (x, y));}
@@ -477,6 +535,7 @@ void Widget::moveTo (const BUtilities::Point<>& position)
 	if ((position_.x != position.x) || (position_.y != position.y))
 	{
 		position_ = position;
+		invalidateGeometry();
 		if (isVisible () && getParentWidget()) getParentWidget()->emitExposeEvent ();
 	}
 }
@@ -530,9 +589,15 @@ BUtilities::Area<> Widget::getArea () const
 
 BUtilities::Point<> Widget::getAbsolutePosition () const
 {
-	BUtilities::Point<> p = BUtilities::Point<> (0, 0);
-	for (const Widget* w = this; w->getParentWidget(); w = w->getParentWidget()) p += w->getPosition();
-	return p;
+	GeometryCache& cache = getGeometryCache();
+	if (!(cache.flags & absolutePositionCached))
+	{
+		const Widget* p = getParentWidget();
+		cache.absolutePosition = (p ? p->getAbsolutePosition() + getPosition() : BUtilities::Point<> (0, 0));
+		cache.flags |= absolutePositionCached;
+	}
+
+	return cache.absolutePosition;
 }
 
 BUtilities::Area<> Widget::getAbsoluteArea () const
@@ -634,7 +699,11 @@ inline void Widget::leave ()
 
 void Widget::setStacking (const Widget::StackingType stacking) 
 {
-	stacking_ = stacking;
+	if (stacking != stacking_)
+	{
+		stacking_ = stacking;
+		invalidateGeometry();
+	}
 }
 
 Widget::StackingType Widget::getStacking () const 
@@ -785,12 +854,26 @@ void Widget::setTxColors (const BStyles::ColorMap& colors)
 
 int Widget::getLayer () const
 {
-	for (const Widget* w = this; w != nullptr; w = w->getParentWidget())
+	if (layer_ != BWIDGETS_UNDEFINED_LAYER) return layer_;
+
+	GeometryCache& cache = getGeometryCache();
+	if (!(cache.flags & layerCached))
 	{
-		if (w->layer_ != BWIDGETS_UNDEFINED_LAYER) return w->layer_;
+		const Widget* p = getParentWidget();
+		cache.layer = (p ? p->getLayer() : BWIDGETS_UNDEFINED_LAYER);
+		cache.flags |= layerCached;
 	}
 
-	return BWIDGETS_UNDEFINED_LAYER;
+	return cache.layer;
+}
+
+void Widget::setLayer (const int layer)
+{
+	if (layer != layer_)
+	{
+		invalidateGeometry();
+		Visualizable::setLayer (layer);
+	}
 }
 
 void Widget::setFocusText (std::function<std::string (const Widget* widget)> func)
@@ -811,7 +894,7 @@ std::string Widget::getFocusText () const
 
 void Widget::emitExposeEvent ()
 {
-	BUtilities::Area<> area = getFamilyArea ([] (const Widget* w) {return w->isVisible();});
+	BUtilities::Area<> area = getVisibleAbsoluteFamilyArea ();
 	area.moveTo (getAbsolutePosition ());
 	emitExposeEvent (area);
 }
@@ -855,6 +938,10 @@ Widget* Widget::getWidgetAt	(const BUtilities::Point<>& position,
 							 std::function<bool (Widget* widget)> func,
 							 std::function<bool (Widget* widget)> passfunc)
 {
+	// Use the hit test index of the main window
+	Window* window = getMainWindow();
+	if (window && (window == this)) return window->getIndexedWidgetAt (getAbsolutePosition () + position, func, passfunc);
+
 	BUtilities::Area<> absarea = getAbsoluteArea ();
 	return getWidgetAt (getAbsolutePosition () + position, absarea, absarea, func, passfunc);
 }
@@ -910,6 +997,96 @@ Widget* Widget::getWidgetAt	(const BUtilities::Point<>& abspos,
 	else return nullptr;
 }
 
+void Widget::invalidateGeometry ()
+{
+	// Ancestors: Only the area of the visible escaping children may change
+	for (Widget* p = getParentWidget(); p; p = p->getParentWidget()) p->geometryCache_.flags &= ~escapeAreaCached;
+
+	// This widget and its descendants: All values may change
+	invalidateSubtreeGeometry ();
+	invalidateHitIndex ();
+}
+
+void Widget::invalidateSubtreeGeometry ()
+{
+	geometryCache_.flags = 0;
+	for (Linkable* l : children_)
+	{
+		Widget* w = dynamic_cast<Widget*> (l);
+		if (w) w->invalidateSubtreeGeometry ();
+	}
+}
+
+void Widget::invalidateHitIndex ()
+{
+	Window* window = getMainWindow();
+	if (window) window->hitIndexValid_ = false;
+}
+
+Widget::GeometryCache& Widget::getGeometryCache () const
+{
+	return geometryCache_;
+}
+
+const Widget::SupportTable& Widget::getSupportTable ()
+{
+	if (supportTable_.owner != this)
+	{
+		supportTable_.owner = this;
+		supportTable_.clickable = dynamic_cast<Clickable*> (this);
+		supportTable_.closeable = dynamic_cast<Closeable*> (this);
+		supportTable_.draggable = dynamic_cast<Draggable*> (this);
+		supportTable_.keyPressable = dynamic_cast<KeyPressable*> (this);
+		supportTable_.messagable = dynamic_cast<Messagable*> (this);
+		supportTable_.pointable = dynamic_cast<Pointable*> (this);
+		supportTable_.scrollable = dynamic_cast<Scrollable*> (this);
+		supportTable_.valueable = dynamic_cast<Valueable*> (this);
+	}
+
+	return supportTable_;
+}
+
+BUtilities::Area<> Widget::getVisibleAbsoluteFamilyArea () const
+{
+	GeometryCache& cache = getGeometryCache();
+	if (!(cache.flags & escapeAreaCached))
+	{
+		// Union of the areas of all visible escaping children. Uses the
+		// cached areas of the children.
+		cache.escape = false;
+		cache.escapeArea = BUtilities::Area<> ();
+		for (Linkable* l : children_)
+		{
+			Widget* w = dynamic_cast<Widget*> (l);
+			if (!(w && w->isVisible())) continue;
+
+			w->getVisibleAbsoluteFamilyArea();
+			const GeometryCache& wcache = w->getGeometryCache();
+			BUtilities::Area<> a = w->getAbsoluteArea();
+			bool escape = (w->getStacking() == StackingType::escape);
+			if (wcache.escape)
+			{
+				if (escape) a.extend (wcache.escapeArea);
+				else a = wcache.escapeArea;
+				escape = true;
+			}
+
+			if (escape)
+			{
+				if (cache.escape) cache.escapeArea.extend (a);
+				else cache.escapeArea = a;
+				cache.escape = true;
+			}
+		}
+
+		cache.flags |= escapeAreaCached;
+	}
+
+	BUtilities::Area<> a = getAbsoluteArea();
+	if (cache.escape) a.extend (cache.escapeArea);
+	return a;
+}
+
 BUtilities::Area<> Widget::getFamilyArea (std::function<bool (const Widget* widget)> func) const
 {
 	BUtilities::Area<> a = getAbsoluteFamilyArea (func);
@@ -939,17 +1116,30 @@ BUtilities::Area<> Widget::getAbsoluteFamilyArea (std::function<bool (const Widg
 }
 
 void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Point<> surfaceExtends, const BUtilities::Area<>& area)
+{
+	display (surfaces, BUtilities::Area<> (BUtilities::Point<> (), surfaceExtends), area);
+}
+
+void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const BUtilities::Area<>& area)
 {
 	if (isVisible())
 	{
 		// Calculate absolute area position and start private core method
 		BUtilities::Area<> absArea = area;
 		absArea.moveTo (absArea.getPosition() + getAbsolutePosition());
-		display (surfaces, surfaceExtends, absArea, absArea);
+		absArea.intersect (surfaceArea);
+		const double scale = (getMainWindow() ? getMainWindow()->getSurfaceScale() : 1.0);
+		display (surfaces, surfaceArea, scale, absArea, absArea);
 	}
 }
 
-void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Point<> surfaceExtends, const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area)
+void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const BUtilities::Region<>& region)
+{
+	BUTILITIES_TRACE_SCOPE ("draw", "display");
+	for (const BUtilities::Area<>& a : region) display (surfaces, surfaceArea, a);
+}
+
+void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const double scale, const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area)
 {
 	BUtilities::Area<> a = (getStacking() == StackingType::escape ? outerArea : area);
 	BUtilities::Area<> thisArea = getArea(); 
@@ -957,21 +1147,39 @@ void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilitie
 	a.intersect (thisArea);
 	if (isVisible())
 	{
-		if (a != BUtilities::Area<> ())
+		if ((a.getWidth() > 0.0) && (a.getHeight() > 0.0))
 		{
-			// Update draw
-			if (scheduleDraw_) draw ();
+			// Update draw and (in retained mode) rasterize at the display
+			// scale
+			if (scheduleDraw_) 
+			{
+				const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+				{
+					BUTILITIES_TRACE_SCOPE ("draw", BUtilities::Trace::getTypeName (typeid (*this)));
+					draw ();
+				}
+				Window* main = getMainWindow();
+				if (main) main->addDrawStatistics (this, std::chrono::steady_clock::now() - t0);
+			}
+			cairo_surface_t* ws = rasterize (scale);
 
 			// Copy widgets surface onto the map of layered surfaces
 			if (surfaces.find(getLayer()) == surfaces.end()) 
 			{
-				surfaces[getLayer()] = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, surfaceExtends.x, surfaceExtends.y);
+				cairo_surface_t* ns = cairo_image_surface_create	(CAIRO_FORMAT_ARGB32, 
+																	 std::ceil (surfaceArea.getWidth() * scale), 
+																	 std::ceil (surfaceArea.getHeight() * scale));
+				cairo_surface_set_device_scale (ns, scale, scale);
+				surfaces[getLayer()] = ns;
+				Window* main = getMainWindow();
+				if (main) main->addSurfaceStatistics (ns);
 			}
 
+			// Use the surfaces coordinates
 			cairo_surface_t* s =  surfaces[getLayer()];
 			cairo_t* cr = cairo_create (s);
-			cairo_set_source_surface (cr, cairoSurface(), thisArea.getX(), thisArea.getY());
-			cairo_rectangle (cr, a.getX (), a.getY (), a.getWidth (), a.getHeight ());
+			cairo_set_source_surface (cr, ws, thisArea.getX() - surfaceArea.getX(), thisArea.getY() - surfaceArea.getY());
+			cairo_rectangle (cr, a.getX () - surfaceArea.getX(), a.getY () - surfaceArea.getY(), a.getWidth (), a.getHeight ());
 			cairo_fill (cr);
 			cairo_destroy (cr);
 		}
@@ -979,7 +1187,7 @@ void Widget::display (std::map<int, cairo_surface_t*>& surfaces, const BUtilitie
 		for (Linkable* l : children_)
 		{
 			Widget* w = dynamic_cast<Widget*> (l);
-			if (w) w->display (surfaces, surfaceExtends, outerArea, a);
+			if (w) w->display (surfaces, surfaceArea, scale, outerArea, a);
 		}
 	}
 }
@@ -999,7 +1207,6 @@ void Widget::draw (const BUtilities::Area<>& area)
 	Visualizable::draw (area);
 
 	if ((!cairoSurface()) || (cairo_surface_status (cairoSurface()) != CAIRO_STATUS_SUCCESS)) return;
-	cairoplus_surface_clear (cairoSurface());
 	cairo_t* cr = cairo_create (cairoSurface());
 
 	if (cairo_status (cr) == CAIRO_STATUS_SUCCESS)
@@ -1008,6 +1215,13 @@ void Widget::draw (const BUtilities::Area<>& area)
 		cairo_rectangle (cr, area.getX (), area.getY (), area.getWidth (), area.getHeight ());
 		cairo_clip (cr);
 
+		// Only clear the drawing area. Thus, a partial draw keeps the rest of
+		// the surface (or of the recording in retained mode).
+		cairo_save (cr);
+		cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (cr);
+		cairo_restore (cr);
+
 		BStyles::Border border = getBorder();
 		BStyles::Fill background = getBackground();
 
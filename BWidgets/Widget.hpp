@@ -20,11 +20,14 @@
 
 #include <cstdint>
 #include <functional>
-#include <set>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include "Draws/Ergo/definitions.hpp"
 #include "../BDevices/Device.hpp"
 #include "../BUtilities/Dictionary.hpp"
+#include "../BUtilities/Region.hpp"
 #include "Supports/Linkable.hpp"
 #include "Supports/Visualizable.hpp"
 #include "Supports/EventMergeable.hpp"
@@ -63,6 +66,14 @@ namespace BWidgets
 
 // Forward declarations
 class Window;
+class Clickable;
+class Closeable;
+class Draggable;
+class KeyPressable;
+class Messagable;
+class Pointable;
+class Scrollable;
+class Valueable;
 
 /**
  *  @brief  Root widget class of BWidgets. All other widgets (including Window)
@@ -106,6 +117,7 @@ class Widget :	public Linkable,
 				public Activatable,
 				public Enterable
 {
+	friend class Window;
 
 protected:
 
@@ -136,7 +148,45 @@ protected:
 	Widget* focus_;
 	std::function<std::string (const Widget* widget)> focusTextFunction_;
 	bool pushStyle_;
-	std::set<BDevices::Device*> devices_;
+	std::vector<std::unique_ptr<BDevices::Device>> devices_;
+
+	struct GeometryCache
+	{
+		uint32_t flags;
+		BUtilities::Point<> absolutePosition;
+		bool visible;
+		int layer;
+		bool escape;
+		BUtilities::Area<> escapeArea;
+	};
+
+	enum GeometryCacheFlags : uint32_t
+	{
+		absolutePositionCached	= 0x01,
+		visibleCached			= 0x02,
+		layerCached				= 0x04,
+		escapeAreaCached		= 0x08
+	};
+
+	mutable GeometryCache geometryCache_;
+	BEvents::Event* queuedEventsFront_;		// Queued events of this widget
+	BEvents::Event* queuedEventsBack_;
+	BEvents::Event* requestEventsFront_;	// Queued events requesting this widget
+
+	struct SupportTable
+	{
+		const Widget* owner;
+		Clickable* clickable;
+		Closeable* closeable;
+		Draggable* draggable;
+		KeyPressable* keyPressable;
+		Messagable* messagable;
+		Pointable* pointable;
+		Scrollable* scrollable;
+		Valueable* valueable;
+	};
+
+	SupportTable supportTable_;
 
 public:
 
@@ -250,6 +300,9 @@ public:
 	 * @brief  Takes control over a device. 
 	 * 
 	 * @param device  Device.
+	 *
+	 * Grabbing an already grabbed device replaces the stored device data
+	 * (e.g., position and action time).
 	 */
 	virtual void grabDevice (const BDevices::Device& device);
 
@@ -366,7 +419,11 @@ public:
 	template<class T>
 	void set (const bool status)
 	{
-		if (dynamic_cast<T*>(this)) T::setSupport (status);
+		if (dynamic_cast<T*>(this)) 
+		{
+			T::setSupport (status);
+			invalidateGeometry();
+		}
 	}
 
 	/**
@@ -379,7 +436,34 @@ public:
 	template<class T>
 	bool is ()
 	{
-		return (dynamic_cast<T*>(this) && dynamic_cast<T*>(this)->getSupport());
+		T* t = as<T>();
+		return (t && t->getSupport());
+	}
+
+	/**
+	 *  @brief  Generic access to Supports.
+	 *  @tparam T  Type of Support.
+	 *  @return  Pointer to the Support @a T of this %Widget or nullptr if
+	 *  this %Widget doesn't provide @a T .
+	 *
+	 *  Supports used by the event dispatch (Clickable, Closeable, Draggable,
+	 *  KeyPressable, Messagable, Pointable, Scrollable, Valueable) are taken
+	 *  from a support table. This table is resolved once upon the first 
+	 *  request. All other Supports are resolved by @c dynamic_cast .
+	 */
+	template<class T>
+	T* as ()
+	{
+		if constexpr (std::is_base_of<T, Widget>::value) return this;
+		else if constexpr (std::is_same<T, Clickable>::value) return getSupportTable().clickable;
+		else if constexpr (std::is_same<T, Closeable>::value) return getSupportTable().closeable;
+		else if constexpr (std::is_same<T, Draggable>::value) return getSupportTable().draggable;
+		else if constexpr (std::is_same<T, KeyPressable>::value) return getSupportTable().keyPressable;
+		else if constexpr (std::is_same<T, Messagable>::value) return getSupportTable().messagable;
+		else if constexpr (std::is_same<T, Pointable>::value) return getSupportTable().pointable;
+		else if constexpr (std::is_same<T, Scrollable>::value) return getSupportTable().scrollable;
+		else if constexpr (std::is_same<T, Valueable>::value) return getSupportTable().valueable;
+		else return dynamic_cast<T*>(this);
 	}
 
     /**
@@ -750,6 +834,12 @@ public:
     virtual int getLayer () const override;
 
 	/**
+     *  @brief  Sets the layer index of the object surface.
+     *  @param layer  Layer index.
+     */
+    virtual void setLayer (const int layer) override;
+
+	/**
 	 *  @brief  Sets the focus_ Widget text by providing a function.
 	 * 
 	 *  @param func  Function providing a text string.
@@ -858,6 +948,37 @@ protected:
 	 */
 	virtual void display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Point<> surfaceExtends, const BUtilities::Area<>& area);
 
+	/**
+	 *  @brief  Draws %Widget surface and children surfaces to the provided
+	 *  map of layered target surfaces.
+	 *  @param surfaces  Map of target surfaces.
+	 *  @param surfaceArea  Absolute area covered by the surfaces (to be 
+	 *  created) for each layer.
+	 *  @param area  Clipping area.
+	 *
+	 *  Same as @c display(surfaces, surfaceExtends, area), but the target
+	 *  surfaces only need to cover @a surfaceArea (e.g., the bounding box of
+	 *  the exposed area) and not the whole %Window.
+	 *
+	 *  Newly created target surfaces have got the surface scale of the main
+	 *  Window (see @c Window::getSurfaceScale() ) as device scale. Widgets in
+	 *  retained mode are rasterized at this scale.
+	 */
+	virtual void display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const BUtilities::Area<>& area);
+
+	/**
+	 *  @brief  Draws %Widget surface and children surfaces to the provided
+	 *  map of layered target surfaces.
+	 *  @param surfaces  Map of target surfaces.
+	 *  @param surfaceArea  Absolute area covered by the surfaces (to be 
+	 *  created) for each layer.
+	 *  @param region  Clipping region.
+	 *
+	 *  Same as @c display(surfaces, surfaceArea, area), but only draws the
+	 *  disjoint areas of @a region.
+	 */
+	void display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const BUtilities::Region<>& region);
+
 	/**
      *  @brief  Unclipped draw a %Widget to the surface.
      */
@@ -879,7 +1000,56 @@ protected:
     virtual void draw (const BUtilities::Area<>& area) override;
 
 private:
-	void display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Point<> surfaceExtends, const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area);
+	/**
+	 *  @brief  Invalidates the cached geometry affected by a change of this
+	 *  %Widget. Called upon changes of the widget geometry, visibility, 
+	 *  layer, stacking, or the widget tree.
+	 *
+	 *  Each %Widget caches the values calculated by @c getAbsolutePosition(),
+	 *  @c isVisible(), @c getLayer(), and the area of the visible escaping
+	 *  children. The absolute position, the visibility, and the layer are 
+	 *  inherited from the parent. Thus, they are invalidated for this 
+	 *  %Widget and all its descendants. The area of the escaping children is
+	 *  invalidated for all ancestors. The hit test index is only invalidated
+	 *  for the main Window of this %Widget.
+	 */
+	void invalidateGeometry ();
+
+	/**
+	 *  @brief  Invalidates the cached geometry of this %Widget and all its
+	 *  descendants.
+	 */
+	void invalidateSubtreeGeometry ();
+
+	/**
+	 *  @brief  Invalidates the hit test index of the main Window. Called
+	 *  upon changes of the stacking order.
+	 */
+	void invalidateHitIndex ();
+
+	/**
+	 *  @brief  Gets the geometry cache.
+	 */
+	GeometryCache& getGeometryCache () const;
+
+	/**
+	 *  @brief  Gets the absolute area covered by this %Widget and all its
+	 *  visible children. Cached version of 
+	 *  @c getAbsoluteFamilyArea(isVisible) .
+	 */
+	BUtilities::Area<> getVisibleAbsoluteFamilyArea () const;
+
+	/**
+	 *  @brief  Gets the support table. (Re-)Resolves the table if not yet 
+	 *  done for this %Widget.
+	 *
+	 *  The table can't be resolved in the %Widget constructor as the 
+	 *  dynamic type of the object isn't complete before. Copied or moved 
+	 *  tables are detected by their owner and resolved again.
+	 */
+	const SupportTable& getSupportTable ();
+
+	void display (std::map<int, cairo_surface_t*>& surfaces, const BUtilities::Area<>& surfaceArea, const double scale, const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area);
 
 	Widget* getWidgetAt	(const BUtilities::Point<>& abspos, 
 						 const BUtilities::Area<>& outerArea,
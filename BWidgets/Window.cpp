@@ -22,16 +22,26 @@
 #include <cairo/cairo.h>
 #include "pugl/cairo.h"
 #include "pugl/pugl.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <list>
+#include <thread>
+#include <typeinfo>
+#include <vector>
 #ifdef PKG_HAVE_FONTCONFIG
 #include <fontconfig/fontconfig.h>
 #endif /*PKG_HAVE_FONTCONFIG*/
 
 #include "Window.hpp"
+#include "../BUtilities/Trace.hpp"
+#include "../BUtilities/AllocationCounter.hpp"
+#include "../BUtilities/ctz.hpp"
 #include "../BDevices/MouseButton.hpp"
 #include "../BDevices/Keys.hpp"
 #include "../BEvents/ExposeEvent.hpp"
+#include "../BEvents/MessageEvent.hpp"
 #include "../BEvents/PointerEvent.hpp"
 #include "../BEvents/ValueChangedEvent.hpp"
 #include "../BEvents/WheelEvent.hpp"
@@ -59,37 +69,106 @@ Window::Window (const uint32_t urid, const std::string& title) :
 Window::Window (const double width, const double height, PuglNativeView nativeWindow, 
 				uint32_t urid, std::string title, bool resizable,
 				PuglWorldType worldType, int worldFlag) :
+	Window (BackendType::pugl, width, height, nativeWindow, urid, title, resizable, worldType, worldFlag) {}
+
+Window::Window (const double width, const double height, const BackendType backend, uint32_t urid, std::string title) :
+	Window (backend, width, height, 0, urid, title, false, PUGL_MODULE, 0) {}
+
+Window::Window	(const BackendType backend, const double width, const double height, PuglNativeView nativeWindow, 
+				 uint32_t urid, std::string title, bool resizable,
+				 PuglWorldType worldType, int worldFlag) :
 		Widget (0.0, 0.0, width, height, urid, title),
 		EventQueueable(),
 		Closeable(),
 		zoom_ (1.0),
+		backend_ (backend),
 		world_ (NULL), 
 		worldType_ (worldType),
 		view_ (NULL), 
 		nativeWindow_ (nativeWindow),
+		offscreenSurface_ (nullptr),
+		offscreenContext_ (nullptr),
+		offscreenDamage_ (),
 		quit_ (false), 
 		focused_ (false), 
-		pointer_ ()
+		pointer_ (),
+		layerSurfaces_ (),
+		windowSurface_ (nullptr),
+		damage_ (),
+		zoomedSurfaces_ (false),
+		parallelDraw_ (false),
+		parallelComposite_ (false),
+		threadPool_ (),
+		frameRate_ (BWIDGETS_DEFAULT_FRAME_RATE),
+		nextFrame_ (),
+		frameDue_ (),
+		postedDue_ (),
+		postedFrame_ (false),
+		missedFrames_ (0),
+		eventTimeBudget_ (BWIDGETS_DEFAULT_EVENT_TIME_BUDGET),
+		timers_ (),
+		timerIndex_ (),
+		processedTimer_ (0),
+		animations_ (),
+		processingAnimations_ (false),
+		timerCount_ (0),
+		nextAnimationFrame_ (),
+		focusInDue_ (std::chrono::steady_clock::time_point::max()),
+		focusOutDue_ (std::chrono::steady_clock::time_point::max()),
+		crossThreadQueue_ (BWIDGETS_DEFAULT_CROSS_THREAD_QUEUE_SIZE),
+		crossThreadUsed_ (false),
+		wakeUpPending_ (false),
+		wakeUpMutex_ (),
+		wakeUpCondition_ (),
+		crossThreadGeneration_ (0),
+		crossThreadItems_ (),
+		crossThreadValues_ (),
+		crossThreadReleased_ (),
+		deviceGrabs_ (),
+		hitIndexValid_ (false),
+		hitEntries_ (),
+		hitColumns_ (0),
+		hitRows_ (0),
+		hitCellStart_ (),
+		hitCellEntries_ (),
+		hitMarks_ (),
+		hitStamp_ (0),
+		hitPath_ (),
+		hitStack_ (),
+		statistics_ (),
+		frameStatistics_ (),
+		inputPending_ (false),
+		inputTime_ (),
+		recorder_ (),
+		debugDamage_ (false),
+		debugDrawnAreas_ ()
 {
 	main_ = this;
 	layer_ = BWIDGETS_DEFAULT_WINDOW_LAYER;
+	statistics_.inputLatency = -1.0;
+	frameStatistics_.inputLatency = -1.0;
+	crossThreadItems_.reserve (crossThreadQueue_.capacity());
+	crossThreadValues_.reserve (crossThreadQueue_.capacity());
 
-	world_ = puglNewWorld (worldType, worldFlag);
-	puglSetWorldString (world_, PUGL_CLASS_NAME, "BWidgets");
-
-	view_ = puglNewView (world_);
-	if (nativeWindow_ != 0) puglSetParentWindow(view_, nativeWindow_);
-	puglSetViewString(view_, PUGL_WINDOW_TITLE, title.c_str());
-	puglSetPosition(view_, 0, 0);
-	puglSetSizeHint (view_, PUGL_DEFAULT_SIZE, getWidth (), getHeight ());
-	puglSetViewHint(view_, PUGL_RESIZABLE, resizable ? PUGL_TRUE : PUGL_FALSE);
-	puglSetViewHint(view_, PUGL_IGNORE_KEY_REPEAT, PUGL_TRUE);
-	puglSetWorldHandle(world_, this);
-	puglSetHandle (view_, this);
-	puglSetBackend(view_, puglCairoBackend());
-	puglSetEventFunc (view_, Window::translatePuglEvent);
-	puglRealize (view_);
-	puglShow (view_, PUGL_SHOW_RAISE);
+	if (backend_ == BackendType::pugl)
+	{
+		world_ = puglNewWorld (worldType, worldFlag);
+		puglSetWorldString (world_, PUGL_CLASS_NAME, "BWidgets");
+
+		view_ = puglNewView (world_);
+		if (nativeWindow_ != 0) puglSetParentWindow(view_, nativeWindow_);
+		puglSetViewString(view_, PUGL_WINDOW_TITLE, title.c_str());
+		puglSetPosition(view_, 0, 0);
+		puglSetSizeHint (view_, PUGL_DEFAULT_SIZE, getWidth (), getHeight ());
+		puglSetViewHint(view_, PUGL_RESIZABLE, resizable ? PUGL_TRUE : PUGL_FALSE);
+		puglSetViewHint(view_, PUGL_IGNORE_KEY_REPEAT, PUGL_TRUE);
+		puglSetWorldHandle(world_, this);
+		puglSetHandle (view_, this);
+		puglSetBackend(view_, puglCairoBackend());
+		puglSetEventFunc (view_, Window::translatePuglEvent);
+		puglRealize (view_);
+		puglShow (view_, PUGL_SHOW_RAISE);
+	}
 
 	emitExposeEvent();
 }
@@ -103,8 +182,11 @@ Window::~Window ()
 		if (w) release (w);
 	}
 	purgeEventQueue ();
-	puglFreeView (view_);
-	puglFreeWorld (world_);
+	destroySurfaces ();
+	if (offscreenContext_) cairo_destroy (offscreenContext_);
+	if (offscreenSurface_) cairo_surface_destroy (offscreenSurface_);
+	if (view_) puglFreeView (view_);
+	if (world_) puglFreeWorld (world_);
 	main_ = nullptr;	// Important switch for the super destructor. It took
 						// days of debugging ...
 
@@ -123,48 +205,211 @@ Window::~Window ()
 void Window::freeDevice ()
 {
 	Widget::freeDevice();
-	forEachChild
-	(
-		[](Linkable* obj) 
-		{
-			Widget* w = dynamic_cast<Widget*>(obj);
-			if (w) w->freeDevice();
-			return true;
-		}
-	);
+
+	// Collect first. Widget::freeDevice() changes the registry.
+	std::vector<Widget*> widgets;
+	for (const std::pair<const std::unique_ptr<BDevices::Device>, std::vector<Widget*>>& g : deviceGrabs_)
+	{
+		widgets.insert (widgets.end(), g.second.begin(), g.second.end());
+	}
+
+	std::sort (widgets.begin(), widgets.end());
+	widgets.erase (std::unique (widgets.begin(), widgets.end()), widgets.end());
+	for (Widget* w : widgets) w->freeDevice();
+	deviceGrabs_.clear();
 }
 
 void Window::freeDevice (const BDevices::Device &device)
 {
 	Widget::freeDevice (device);
-	forEachChild
-	(
-		[&device](Linkable* obj) 
+
+	std::map<std::unique_ptr<BDevices::Device>, std::vector<Widget*>, DeviceLess>::iterator it = deviceGrabs_.find (device);
+	if (it == deviceGrabs_.end()) return;
+
+	const std::vector<Widget*> widgets = it->second;
+	for (Widget* w : widgets) w->freeDevice (device);
+}
+
+std::list<Widget*> Window::listDeviceGrabbed (const BDevices::Device& device) const
+{
+	std::map<std::unique_ptr<BDevices::Device>, std::vector<Widget*>, DeviceLess>::const_iterator it = deviceGrabs_.find (device);
+	if (it == deviceGrabs_.end()) return std::list<Widget*> ();
+	return std::list<Widget*> (it->second.begin(), it->second.end());
+}
+
+void Window::addDeviceGrab (Widget* widget, const BDevices::Device& device)
+{
+	std::map<std::unique_ptr<BDevices::Device>, std::vector<Widget*>, DeviceLess>::iterator it = deviceGrabs_.find (device);
+	if (it == deviceGrabs_.end()) it = deviceGrabs_.emplace (std::unique_ptr<BDevices::Device> (device.clone()), std::vector<Widget*> ()).first;
+	if (std::find (it->second.begin(), it->second.end(), widget) == it->second.end()) it->second.push_back (widget);
+}
+
+void Window::removeDeviceGrab (Widget* widget, const BDevices::Device& device)
+{
+	std::map<std::unique_ptr<BDevices::Device>, std::vector<Widget*>, DeviceLess>::iterator it = deviceGrabs_.find (device);
+	if (it == deviceGrabs_.end()) return;
+
+	std::vector<Widget*>::iterator wit = std::find (it->second.begin(), it->second.end(), widget);
+	if (wit != it->second.end()) it->second.erase (wit);
+	if (it->second.empty()) deviceGrabs_.erase (it);
+}
+
+void Window::validateHitIndex ()
+{
+	if (hitIndexValid_) return;
+
+	hitEntries_.clear();
+	if (isVisualizable())
+	{
+		const BUtilities::Area<> absarea = getAbsoluteArea();
+		buildHitIndex (this, SIZE_MAX, BUtilities::Point<> (0, 0), absarea, absarea);
+	}
+
+	// Count entries per cell
+	const double cs = BWIDGETS_DEFAULT_HIT_INDEX_CELL_SIZE;
+	const BUtilities::Area<> root = getAbsoluteArea();
+	hitColumns_ = std::max (static_cast<size_t> (std::ceil (root.getWidth() / cs)), static_cast<size_t> (1));
+	hitRows_ = std::max (static_cast<size_t> (std::ceil (root.getHeight() / cs)), static_cast<size_t> (1));
+	hitCellStart_.assign (hitColumns_ * hitRows_ + 1, 0);
+
+	auto cellRange = [this, &root, cs] (const BUtilities::Area<>& a, size_t& x1, size_t& y1, size_t& x2, size_t& y2)
+	{
+		auto col = [this, &root, cs] (const double x) 
 		{
-			Widget* w = dynamic_cast<Widget*>(obj);
-			if (w) w->freeDevice (device);
-			return true;
+			const double c = std::floor ((x - root.getX()) / cs);
+			return static_cast<size_t> (std::max (std::min (c, static_cast<double> (hitColumns_ - 1)), 0.0));
+		};
+
+		auto row = [this, &root, cs] (const double y) 
+		{
+			const double r = std::floor ((y - root.getY()) / cs);
+			return static_cast<size_t> (std::max (std::min (r, static_cast<double> (hitRows_ - 1)), 0.0));
+		};
+
+		x1 = col (a.getX());
+		x2 = col (a.getX() + a.getWidth());
+		y1 = row (a.getY());
+		y2 = row (a.getY() + a.getHeight());
+	};
+
+	for (const HitEntry& e : hitEntries_)
+	{
+		if (e.area == BUtilities::Area<> ()) continue;
+		size_t x1, y1, x2, y2;
+		cellRange (e.area, x1, y1, x2, y2);
+		for (size_t y = y1; y <= y2; ++y)
+		{
+			for (size_t x = x1; x <= x2; ++x) ++hitCellStart_[y * hitColumns_ + x + 1];
 		}
-	);
+	}
+
+	for (size_t i = 1; i < hitCellStart_.size(); ++i) hitCellStart_[i] += hitCellStart_[i - 1];
+
+	// Fill cells
+	hitCellEntries_.resize (hitCellStart_.back());
+	std::vector<size_t> fill (hitCellStart_.begin(), std::prev (hitCellStart_.end()));
+	for (size_t i = 0; i < hitEntries_.size(); ++i)
+	{
+		const HitEntry& e = hitEntries_[i];
+		if (e.area == BUtilities::Area<> ()) continue;
+		size_t x1, y1, x2, y2;
+		cellRange (e.area, x1, y1, x2, y2);
+		for (size_t y = y1; y <= y2; ++y)
+		{
+			for (size_t x = x1; x <= x2; ++x) hitCellEntries_[fill[y * hitColumns_ + x]++] = i;
+		}
+	}
+
+	hitMarks_.assign (hitEntries_.size(), 0);
+	hitStamp_ = 0;
+	hitIndexValid_ = true;
 }
 
-std::list<Widget*> Window::listDeviceGrabbed (const BDevices::Device& device) const
+void Window::buildHitIndex	(Widget* widget, const size_t parent, const BUtilities::Point<>& abspos,
+							 const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area)
 {
-	std::list<Widget*> widgets;
-	forEachChild
-	(
-		[&device, &widgets] (Linkable* obj)
+	BUtilities::Area<> thisArea = widget->getArea();
+	thisArea.moveTo (abspos);
+	thisArea.intersect (widget->getStacking() == StackingType::escape ? outerArea : area);
+
+	const size_t index = hitEntries_.size();
+	hitEntries_.push_back (HitEntry {widget, thisArea, parent});
+
+	for (Linkable* l : widget->getChildren())
+	{
+		Widget* w = dynamic_cast<Widget*> (l);
+		if (w && w->isVisualizable()) buildHitIndex (w, index, abspos + w->getPosition(), outerArea, thisArea);
+	}
+}
+
+Widget* Window::getIndexedWidgetAt	(const BUtilities::Point<>& abspos, 
+									 std::function<bool (Widget* widget)> func,
+									 std::function<bool (Widget* widget)> passfunc)
+{
+	validateHitIndex();
+	if (hitEntries_.empty()) return nullptr;
+
+	const BUtilities::Area<> root = getAbsoluteArea();
+	if (!root.contains (abspos)) return nullptr;
+
+	// Mark all hit widgets and their parents
+	++hitStamp_;
+	if (hitStamp_ == 0)
+	{
+		hitMarks_.assign (hitEntries_.size(), 0);
+		hitStamp_ = 1;
+	}
+
+	const double cs = BWIDGETS_DEFAULT_HIT_INDEX_CELL_SIZE;
+	const size_t x = std::min (static_cast<size_t> (std::floor ((abspos.x - root.getX()) / cs)), hitColumns_ - 1);
+	const size_t y = std::min (static_cast<size_t> (std::floor ((abspos.y - root.getY()) / cs)), hitRows_ - 1);
+	const size_t cell = y * hitColumns_ + x;
+	hitPath_.clear();
+	for (size_t c = hitCellStart_[cell]; c < hitCellStart_[cell + 1]; ++c)
+	{
+		const size_t i = hitCellEntries_[c];
+		if (!hitEntries_[i].area.contains (abspos)) continue;
+
+		for (size_t j = i; (j != SIZE_MAX) && (hitMarks_[j] != hitStamp_); j = hitEntries_[j].parent)
 		{
-			Widget* w = dynamic_cast<Widget*>(obj);
-			if (w)
-			{
-				if (w->isDeviceGrabbed(device)) widgets.push_back(w);
-			}
-			return true;
+			hitMarks_[j] = hitStamp_;
+			hitPath_.push_back (j);
 		}
-	);
+	}
+
+	// Evaluate the marked part of the tree in tree order like the recursive
+	// Widget::getWidgetAt(). Each stack element takes up the result for a
+	// widget and its already evaluated children.
+	std::sort (hitPath_.begin(), hitPath_.end());
+	hitStack_.clear();
+
+	auto merge = [this] ()
+	{
+		const std::pair<size_t, Widget*> child = hitStack_.back();
+		hitStack_.pop_back();
+		if (!child.second) return;
+
+		std::pair<size_t, Widget*>& parent = hitStack_.back();
+		if (!parent.second) parent.second = child.second;
+		else if (hitEntries_[child.first].widget->getLayer() <= hitEntries_[parent.first].widget->getLayer()) parent.second = child.second;
+	};
+
+	for (const size_t j : hitPath_)
+	{
+		const HitEntry& e = hitEntries_[j];
+		while ((!hitStack_.empty()) && (hitStack_.back().first != e.parent)) merge();
+
+		Widget* finalw = nullptr;
+		if ((e.area != BUtilities::Area<> ()) && e.area.contains (abspos))
+		{
+			finalw = (passfunc (e.widget) ? nullptr : (func (e.widget) ? e.widget : this));	// Window as "sink" to block passing events
+		}
+
+		hitStack_.push_back (std::make_pair (j, finalw));
+	}
 
-	return widgets;
+	while (hitStack_.size() > 1) merge();
+	return (hitStack_.empty() ? nullptr : hitStack_.front().second);
 }
 
 void Window::setZoom (const double zoom)
@@ -181,6 +426,45 @@ double Window::getZoom () const
 	return zoom_;
 }
 
+void Window::setZoomedSurfaces (const bool status)
+{
+	if (status != zoomedSurfaces_)
+	{
+		zoomedSurfaces_ = status;
+		update();
+	}
+}
+
+bool Window::isZoomedSurfaces () const
+{
+	return zoomedSurfaces_;
+}
+
+double Window::getSurfaceScale () const
+{
+	return (zoomedSurfaces_ ? getZoom() : 1.0);
+}
+
+void Window::setParallelDraw (const bool status)
+{
+	parallelDraw_ = status;
+}
+
+bool Window::isParallelDraw () const
+{
+	return parallelDraw_;
+}
+
+void Window::setParallelComposite (const bool status)
+{
+	parallelComposite_ = status;
+}
+
+bool Window::isParallelComposite () const
+{
+	return parallelComposite_;
+}
+
 PuglNativeView Window::getNativeView ()
 {
 	return (view_ ? puglGetNativeView(view_) : 0);
@@ -190,12 +474,73 @@ PuglView* Window::getView () {return view_;}
 
 cairo_t* Window::getCairoContext ()
 {
+	if (backend_ == BackendType::headless) 
+	{
+		// (Re-)create the offscreen surface if it doesn't match the zoomed
+		// window extends
+		const int width = std::ceil (getWidth() * getZoom());
+		const int height = std::ceil (getHeight() * getZoom());
+		if
+		(
+			(!offscreenSurface_) ||
+			(cairo_image_surface_get_width (offscreenSurface_) != width) ||
+			(cairo_image_surface_get_height (offscreenSurface_) != height)
+		)
+		{
+			if (offscreenContext_) cairo_destroy (offscreenContext_);
+			if (offscreenSurface_) cairo_surface_destroy (offscreenSurface_);
+			offscreenSurface_ = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+			offscreenContext_ = cairo_create (offscreenSurface_);
+		}
+
+		return offscreenContext_;
+	}
+
 	return (view_ ? static_cast<cairo_t*>(puglGetContext(view_)): nullptr);
 }
 
+Window::BackendType Window::getBackend () const
+{
+	return backend_;
+}
+
+cairo_surface_t* Window::getOffscreenSurface ()
+{
+	if (offscreenSurface_) cairo_surface_flush (offscreenSurface_);
+	return offscreenSurface_;
+}
+
+PuglStatus Window::injectEvent (const PuglEvent& event)
+{
+	const PuglStatus status = translateEvent (&event);
+	wakeUp ();
+	return status;
+}
+
+bool Window::startRecording (const std::string& filename)
+{
+	return recorder_.open (filename);
+}
+
+void Window::stopRecording ()
+{
+	recorder_.close ();
+}
+
+bool Window::isRecording () const
+{
+	return recorder_.isOpen ();
+}
+
 void Window::run ()
 {
-	while (!quit_) handleEvents();
+	// Sleep in puglUpdate until the next host event or deadline. Then
+	// handle the events via the (maybe overridden) handleEvents().
+	while (!quit_)
+	{
+		waitForEvents (getTimeout ());
+		handleEvents ();
+	}
 }
 
 void Window::onConfigureRequest (BEvents::Event* event)
@@ -216,150 +561,441 @@ void Window::onCloseRequest (BEvents::Event* event)
 void Window::onExposeRequest (BEvents::Event* event)
 {
 	BEvents::ExposeEvent* ev = dynamic_cast<BEvents::ExposeEvent*>(event);
-	if (ev) puglPostRedisplayRect (view_,	{static_cast<PuglCoord>(ev->getArea().getX() * getZoom()), 
-											 static_cast<PuglCoord>(ev->getArea().getY() * getZoom()), 
-											 static_cast<PuglSpan>((ev->getArea().getWidth()) * getZoom()), 
-											 static_cast<PuglSpan>((ev->getArea().getHeight()) * getZoom())});
+	if (!ev) return;
+
+	// A new frame becomes due with the first damage since the last frame,
+	// but not before the end of the frame interval
+	if (damage_.empty()) frameDue_ = std::max (std::chrono::steady_clock::now(), nextFrame_);
+
+	for (const BUtilities::Area<>& a : ev->getRegion())
+	{
+		// Snap the area to full pixels of the retained surfaces
+		const double scale = getSurfaceScale();
+		const double x1 = std::floor (a.getX() * scale);
+		const double y1 = std::floor (a.getY() * scale);
+		const double x2 = std::ceil ((a.getX() + a.getWidth()) * scale);
+		const double y2 = std::ceil ((a.getY() + a.getHeight()) * scale);
+		if ((x2 <= x1) || (y2 <= y1)) continue;
+
+		// Add it to the damaged region
+		damage_.add (BUtilities::Area<> (x1 / scale, y1 / scale, (x2 - x1) / scale, (y2 - y1) / scale));
+	}
+
+	// Too fragmented? Fall back to the bounding box
+	if (damage_.size() > BWIDGETS_DEFAULT_MAX_DAMAGE_AREAS) damage_ = BUtilities::Region<> (damage_.getArea());
+
+	// Unpaced: Post immediately. Otherwise, wait for the frame deadline.
+	if (frameRate_ <= 0.0) postDamage ();
+}
+
+void Window::setFrameRate (const double fps)
+{
+	frameRate_ = std::max (fps, 0.0);
+}
+
+double Window::getFrameRate () const
+{
+	return frameRate_;
+}
+
+unsigned long Window::getMissedFrames () const
+{
+	return missedFrames_;
+}
+
+void Window::setEventTimeBudget (const double seconds)
+{
+	eventTimeBudget_ = std::max (seconds, 0.0);
+}
+
+double Window::getEventTimeBudget () const
+{
+	return eventTimeBudget_;
+}
+
+const Window::FrameStatistics& Window::getFrameStatistics () const
+{
+	return frameStatistics_;
+}
+
+void Window::setDebugDamage (const bool status)
+{
+	debugDamage_ = status;
+	debugDrawnAreas_.clear();
+}
+
+bool Window::isDebugDamage () const
+{
+	return debugDamage_;
+}
+
+void Window::addDrawStatistics (const Widget* widget, const std::chrono::steady_clock::duration time)
+{
+	const double t = std::chrono::duration<double> (time).count();
+	++statistics_.drawnWidgets;
+	statistics_.drawTime += t;
+	DrawStatistics& ds = statistics_.classDrawStatistics[std::type_index (typeid (*widget))];
+	++ds.count;
+	ds.time += t;
+	if (debugDamage_) debugDrawnAreas_.push_back (widget->getAbsoluteArea());
+}
+
+void Window::addSurfaceStatistics (cairo_surface_t* surface)
+{
+	if (surface && (cairo_surface_status (surface) == CAIRO_STATUS_SUCCESS))
+	{
+		statistics_.surfaceBytes += static_cast<size_t> (cairo_image_surface_get_stride (surface)) * cairo_image_surface_get_height (surface);
+	}
+}
+
+void Window::addDamageStatistics (const BUtilities::Region<>& region)
+{
+	for (const BUtilities::Area<>& a : region)
+	{
+		const double scale = getSurfaceScale();
+		const double x1 = std::floor (a.getX() * scale);
+		const double y1 = std::floor (a.getY() * scale);
+		const double x2 = std::ceil ((a.getX() + a.getWidth()) * scale);
+		const double y2 = std::ceil ((a.getY() + a.getHeight()) * scale);
+		const size_t pixels = static_cast<size_t> (x2 - x1) * static_cast<size_t> (y2 - y1);
+		statistics_.damage.push_back (DamageStatistics {a, pixels});
+		statistics_.damagePixels += pixels;
+	}
+}
+
+void Window::paintDebugDamage (cairo_t* cr, const BUtilities::Region<>& region)
+{
+	cairo_save (cr);
+	cairo_scale (cr, getZoom(), getZoom());
+
+	// Tint recomposited areas
+	for (const BUtilities::Area<>& a : region) cairo_rectangle (cr, a.getX(), a.getY(), a.getWidth(), a.getHeight());
+	cairo_set_source_rgba (cr, 1.0, 0.0, 0.0, 0.25);
+	cairo_fill (cr);
+
+	// Outline drawn widgets
+	for (const BUtilities::Area<>& a : debugDrawnAreas_) cairo_rectangle (cr, a.getX() + 0.5, a.getY() + 0.5, a.getWidth() - 1.0, a.getHeight() - 1.0);
+	cairo_set_line_width (cr, 1.0);
+	cairo_set_source_rgba (cr, 0.0, 0.5, 1.0, 0.8);
+	cairo_stroke (cr);
+
+	cairo_restore (cr);
+	debugDrawnAreas_.clear();
+}
+
+void Window::finishFrameStatistics ()
+{
+	if (inputPending_)
+	{
+		statistics_.inputLatency = std::chrono::duration<double> (std::chrono::steady_clock::now() - inputTime_).count();
+		inputPending_ = false;
+	}
+	statistics_.frame = frameStatistics_.frame + 1;
+#ifdef BUTILITIES_ALLOCATION_COUNTER
+	for (size_t i = 0; i < statistics_.allocations.size(); ++i)
+	{
+		statistics_.allocations[i] = BUtilities::AllocationCounter::take (static_cast<BUtilities::AllocationCounter::Phase> (i), &allocationSink_);
+	}
+#endif /* BUTILITIES_ALLOCATION_COUNTER */
+
+	// Swap and reset. Keeps the allocated class draw statistics nodes.
+	std::swap (statistics_, frameStatistics_);
+	statistics_.events.fill (0);
+	statistics_.mergedEvents = 0;
+	statistics_.maxQueueSize = getEventQueueSize();
+	statistics_.drawnWidgets = 0;
+	statistics_.drawTime = 0.0;
+	for (std::pair<const std::type_index, DrawStatistics>& ds : statistics_.classDrawStatistics) ds.second = DrawStatistics {0, 0.0};
+	statistics_.compositeTime = 0.0;
+	statistics_.surfaceBytes = 0;
+	statistics_.damage.clear();
+	statistics_.damagePixels = 0;
+	statistics_.allocations.fill (BUtilities::AllocationCounter::Statistics {0, 0});
+	statistics_.inputLatency = -1.0;
 }
 
 void Window::addEventToQueue (BEvents::Event* event)
 {
-	// Try to merge with precursor event
+	if (!event) return;
+
+	// Don't add the same event pointer twice
+	if (isEventQueued (event)) return;
+
+	// Try to merge with the last queued event of the same widget and type
+	const BEvents::Event::EventType eventType = event->getEventType();
+	Widget* widget = event->getWidget();
 	if
 	(
-		(event) &&
-		(event->getWidget()) &&
-		(!eventQueue_.empty ()) &&
-		(eventQueue_.back())
-	)
-	{
-		BEvents::Event::EventType eventType = event->getEventType();
-
-		if
+		(widget) &&
+		(widget->isEventMergeable(eventType)) &&
 		(
-			(event->getWidget()->isEventMergeable(eventType)) &&
-			(
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) ||
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) ||
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerMotionEvent)) ||
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerDragEvent)) ||
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::wheelScrollEvent)) ||
-				(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::valueChangedEvent))
-			)
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) ||
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) ||
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerMotionEvent)) ||
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerDragEvent)) ||
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::wheelScrollEvent)) ||
+			(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::valueChangedEvent))
 		)
+	)
+	{
+		// Search the last queued event of the widget with the same type
+		BEvents::Event* precursor = widget->queuedEventsBack_;
+		while (precursor && (precursor->getEventType() != eventType)) precursor = precursor->widgetPrev_;
+		if (precursor)
 		{
-			// Check for mergeable precursor events
-			for (std::list<BEvents::Event*>::reverse_iterator rit = eventQueue_.rbegin(); rit != eventQueue_.rend(); ++rit)
+
+			// CONFIGURE_EVENT
+			if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent))
 			{
-				BEvents::Event* precursor = *rit;
+				BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
+				BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
 
-				// Don't add the same event pointer twice
-				if (precursor == event)
+				BUtilities::Area<> area = nextEvent->getArea ();
+				firstEvent->setArea (area);
 
-				if ((static_cast<uint32_t>(precursor->getEventType()) & static_cast<uint32_t>(eventType)) && (event->getWidget () == precursor->getWidget ()))
-				{
-					// CONFIGURE_EVENT
-					if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent))
-					{
-						BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
-						BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
+				++statistics_.mergedEvents;
+				delete event;
+				return;
+			}
 
-						BUtilities::Area<> area = nextEvent->getArea ();
-						firstEvent->setArea (area);
+			// EXPOSE_EVENT
+			else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent))
+			{
+				BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
+				BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
 
-						delete event;
-						return;
-					}
+				firstEvent->addArea (nextEvent->getRegion ());
 
-					// EXPOSE_EVENT
-					if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent))
-					{
-						BEvents::ExposeEvent* firstEvent = (BEvents::ExposeEvent*) precursor;
-						BEvents::ExposeEvent* nextEvent = (BEvents::ExposeEvent*) event;
+				++statistics_.mergedEvents;
+				delete event;
+				return;
+			}
 
-						BUtilities::Area<> area = firstEvent->getArea ();
-						area.extend (nextEvent->getArea ());
-						firstEvent->setArea (area);
+			// pointerMotionEvent
+			else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerMotionEvent))
+			{
+				BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
+				BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
 
-						delete event;
-						return;
-					}
+				firstEvent->setPosition (nextEvent->getPosition ());
+				firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
+				++statistics_.mergedEvents;
+				delete event;
+				return;
+			}
 
-					// pointerMotionEvent
-					else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerMotionEvent))
-					{
-						BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
-						BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
+			// pointerDragEvent
+			else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerDragEvent))
+			{
+				BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
+				BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
 
-						firstEvent->setPosition (nextEvent->getPosition ());
-						firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
+				if
+				(
+					(nextEvent->getButton() == firstEvent->getButton()) &&
+					(nextEvent->getOrigin() == firstEvent->getOrigin())
+				)
+				{
+					firstEvent->setPosition (nextEvent->getPosition ());
+					firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
-						delete event;
-						return;
-					}
+					++statistics_.mergedEvents;
+					delete event;
+					return;
+				}
+			}
 
-					// pointerDragEvent
-					else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::pointerDragEvent))
-					{
-						BEvents::PointerEvent* firstEvent = (BEvents::PointerEvent*) precursor;
-						BEvents::PointerEvent* nextEvent = (BEvents::PointerEvent*) event;
+			// wheelScrollEvent
+			else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::wheelScrollEvent))
+			{
+				BEvents::WheelEvent* firstEvent = (BEvents::WheelEvent*) precursor;
+				BEvents::WheelEvent* nextEvent = (BEvents::WheelEvent*) event;
 
-						if
-						(
-							(nextEvent->getButton() == firstEvent->getButton()) &&
-							(nextEvent->getOrigin() == firstEvent->getOrigin())
-						)
-						{
-							firstEvent->setPosition (nextEvent->getPosition ());
-							firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
+				if (nextEvent->getPosition() == firstEvent->getPosition())
+				{
+					firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
 
-							delete event;
-							return;
-						}
-					}
+					++statistics_.mergedEvents;
+					delete event;
+					return;
+				}
+			}
 
+			// ValueChangedEvent
+			else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::valueChangedEvent))
+			{
+				if (dynamic_cast<BEvents::ValueChangedEvent*>(precursor))
+				{
+					dynamic_cast<BEvents::ValueChangedEvent*>(precursor)->setValue (event);
+					++statistics_.mergedEvents;
+					delete event;
+					return;
+				}
+			}
+		}
+	}
 
-					// wheelScrollEvent
-					else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::wheelScrollEvent))
-					{
-						BEvents::WheelEvent* firstEvent = (BEvents::WheelEvent*) precursor;
-						BEvents::WheelEvent* nextEvent = (BEvents::WheelEvent*) event;
+	// Not queueable: discard event
+	if (!isEventQueueable (eventType))
+	{
+		delete event;
+		return;
+	}
 
-						if (nextEvent->getPosition() == firstEvent->getPosition())
-						{
-							firstEvent->setDelta (firstEvent->getDelta () + nextEvent->getDelta ());
+	EventQueueable::addEventToQueue (event);
+	indexEvent (event);
+}
 
-							delete event;
-							return;
-						}
-					}
+BEvents::Event* Window::popEvent ()
+{
+	BEvents::Event* event = EventQueueable::popEvent();
+	if (event) unindexEvent (event);
+	return event;
+}
 
-					// ValueChangedEvent
-					else if (static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::valueChangedEvent))
-					{
-						if (dynamic_cast<BEvents::ValueChangedEvent*>(precursor))
-						{
-							dynamic_cast<BEvents::ValueChangedEvent*>(precursor)->setValue (event);
-							delete event;
-						}
-						
-						return;
-					}
-				}
-			}
+BEvents::Event* Window::popEvent (BEvents::Event* event)
+{
+	BEvents::Event* e = EventQueueable::popEvent (event);
+	if (e) unindexEvent (e);
+	return e;
+}
+
+void Window::indexEvent (BEvents::Event* event)
+{
+	Widget* widget = event->getWidget();
+	const BEvents::Event::EventType eventType = event->getEventType();
+	statistics_.maxQueueSize = std::max (statistics_.maxQueueSize, getEventQueueSize());
+
+	// Append to the events of the widget
+	if (widget)
+	{
+		event->widgetPrev_ = widget->queuedEventsBack_;
+		event->widgetNext_ = nullptr;
+		if (widget->queuedEventsBack_) widget->queuedEventsBack_->widgetNext_ = event;
+		else widget->queuedEventsFront_ = event;
+		widget->queuedEventsBack_ = event;
+	}
+
+	// Request widgets
+	if
+	(
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) ||
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) ||
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::closeRequestEvent))
+	)
+	{
+		Widget* request = ((BEvents::WidgetEvent*)event)->getRequestWidget ();
+		if (request)
+		{
+			event->requestPrev_ = nullptr;
+			event->requestNext_ = request->requestEventsFront_;
+			if (request->requestEventsFront_) request->requestEventsFront_->requestPrev_ = event;
+			request->requestEventsFront_ = event;
 		}
 	}
+}
+
+void Window::unindexEvent (BEvents::Event* event)
+{
+	Widget* widget = event->getWidget();
+	const BEvents::Event::EventType eventType = event->getEventType();
+	if (widget)
+	{
+		if (event->widgetPrev_) event->widgetPrev_->widgetNext_ = event->widgetNext_;
+		else if (widget->queuedEventsFront_ == event) widget->queuedEventsFront_ = event->widgetNext_;
+		if (event->widgetNext_) event->widgetNext_->widgetPrev_ = event->widgetPrev_;
+		else if (widget->queuedEventsBack_ == event) widget->queuedEventsBack_ = event->widgetPrev_;
+		event->widgetPrev_ = nullptr;
+		event->widgetNext_ = nullptr;
+	}
+
+	// Request widgets
+	if
+	(
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) ||
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) ||
+		(static_cast<uint32_t>(eventType) & static_cast<uint32_t>(BEvents::Event::EventType::closeRequestEvent))
+	)
+	{
+		Widget* request = ((BEvents::WidgetEvent*)event)->getRequestWidget ();
+		if (request)
+		{
+			if (event->requestPrev_) event->requestPrev_->requestNext_ = event->requestNext_;
+			else if (request->requestEventsFront_ == event) request->requestEventsFront_ = event->requestNext_;
+			if (event->requestNext_) event->requestNext_->requestPrev_ = event->requestPrev_;
+			event->requestPrev_ = nullptr;
+			event->requestNext_ = nullptr;
+		}
+	}
+}
+
+
+#ifdef BUTILITIES_TRACE
+static const char* getTraceName (const BEvents::Event::EventType eventType)
+{
+	switch (eventType)
+	{
+		case BEvents::Event::EventType::configureRequestEvent:	return "configureRequestEvent";
+		case BEvents::Event::EventType::exposeRequestEvent:		return "exposeRequestEvent";
+		case BEvents::Event::EventType::closeRequestEvent:		return "closeRequestEvent";
+		case BEvents::Event::EventType::keyPressEvent:			return "keyPressEvent";
+		case BEvents::Event::EventType::keyReleaseEvent:		return "keyReleaseEvent";
+		case BEvents::Event::EventType::buttonPressEvent:		return "buttonPressEvent";
+		case BEvents::Event::EventType::buttonReleaseEvent:		return "buttonReleaseEvent";
+		case BEvents::Event::EventType::buttonClickEvent:		return "buttonClickEvent";
+		case BEvents::Event::EventType::pointerDragEvent:		return "pointerDragEvent";
+		case BEvents::Event::EventType::pointerMotionEvent:		return "pointerMotionEvent";
+		case BEvents::Event::EventType::wheelScrollEvent:		return "wheelScrollEvent";
+		case BEvents::Event::EventType::valueChangedEvent:		return "valueChangedEvent";
+		case BEvents::Event::EventType::messageEvent:			return "messageEvent";
+		case BEvents::Event::EventType::pointerFocusInEvent:	return "pointerFocusInEvent";
+		case BEvents::Event::EventType::pointerFocusOutEvent:	return "pointerFocusOutEvent";
+		default:												return "event";
+	}
+}
+#endif
 
-	EventQueueable::addEventToQueue (event);
+void Window::waitForEvents (const double timeout)
+{
+	BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::dispatchPhase, &allocationSink_);
+
+	if (world_) puglUpdate (world_, timeout);
+
+	// No windowing system: Wait for the next deadline or a wake up
+	else if (timeout != 0.0)
+	{
+		std::unique_lock<std::mutex> lock (wakeUpMutex_);
+		const auto woken = [this] () {return wakeUpPending_.load (std::memory_order_acquire);};
+		if (timeout > 0.0) wakeUpCondition_.wait_for (lock, std::chrono::duration<double> (timeout), woken);
+		else wakeUpCondition_.wait (lock, woken);
+	}
 }
 
 void Window::handleEvents ()
 {
-	puglUpdate (world_, 0);
-	translateTimeEvent ();
+	BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::dispatchPhase, &allocationSink_);
+
+	// Translate pending host events (non-blocking)
+	if (world_) puglUpdate (world_, 0.0);
+
+	// From now on, other threads need to wake up the event loop again
+	wakeUpPending_.exchange (false, std::memory_order_acq_rel);
+
+	BUTILITIES_TRACE_SCOPE ("events", "handleEvents");
+	processCrossThreadItems ();
+	processTimers ();
+	processFocus ();
+	processAnimations ();
+
+	const std::chrono::steady_clock::time_point deadline = 
+	(
+		eventTimeBudget_ > 0.0 ?
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration> (std::chrono::duration<double> (eventTimeBudget_)) :
+		std::chrono::steady_clock::time_point::max()
+	);
 
-	while (!eventQueue_.empty ())
+	while (!isEventQueueEmpty ())
 	{
 		BEvents::Event* event = popEvent();
 
@@ -369,6 +1005,13 @@ void Window::handleEvents ()
 			if (widget)
 			{
 				BEvents::Event::EventType eventType = event->getEventType ();
+				const uint32_t typeBits = static_cast<uint32_t> (eventType);
+				if (typeBits)
+				{
+					const size_t typeIndex = BUtilities::ctz (typeBits);
+					if (typeIndex < statistics_.events.size()) ++statistics_.events[typeIndex];
+				}
+				BUTILITIES_TRACE_SCOPE ("events", getTraceName (eventType));
 
 				switch (eventType)
 				{
@@ -382,19 +1025,19 @@ void Window::handleEvents ()
 					break;
 
 				case BEvents::Event::EventType::closeRequestEvent:
-					if (widget->is<Closeable>()) dynamic_cast<Closeable*> (widget)->onCloseRequest (event);
+					if (widget->is<Closeable>()) widget->as<Closeable>()->onCloseRequest (event);
 					break;
 
 				case BEvents::Event::EventType::keyPressEvent:
 					unfocus();
 					freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
-					if (widget->is<KeyPressable>()) dynamic_cast<KeyPressable*> (widget)->onKeyPressed (event);
+					if (widget->is<KeyPressable>()) widget->as<KeyPressable>()->onKeyPressed (event);
 					break;
 
 				case BEvents::Event::EventType::keyReleaseEvent:
 					unfocus();
 					freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
-					if (widget->is<KeyPressable>()) dynamic_cast<KeyPressable*> (widget)->onKeyReleased (event);
+					if (widget->is<KeyPressable>()) widget->as<KeyPressable>()->onKeyReleased (event);
 					break;
 
 				case BEvents::Event::EventType::buttonPressEvent:
@@ -403,7 +1046,7 @@ void Window::handleEvents ()
 						unfocus();
 						freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
 						widget->grabDevice(BDevices::MouseButton (be->getButton(), be->getPosition()));
-						if (widget->is<Clickable>()) dynamic_cast<Clickable*> (widget)->onButtonPressed (be);
+						if (widget->is<Clickable>()) widget->as<Clickable>()->onButtonPressed (be);
 					}
 					break;
 
@@ -413,7 +1056,7 @@ void Window::handleEvents ()
 						unfocus ();
 						freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
 						widget->freeDevice (BDevices::MouseButton (be->getButton ()));
-						if (widget->is<Clickable>()) dynamic_cast<Clickable*> (widget)->onButtonReleased (be);
+						if (widget->is<Clickable>()) widget->as<Clickable>()->onButtonReleased (be);
 					}
 					break;
 
@@ -423,7 +1066,7 @@ void Window::handleEvents ()
 						unfocus ();
 						freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
 						widget->freeDevice (BDevices::MouseButton (be->getButton ()));
-						if (widget->is<Clickable>()) dynamic_cast<Clickable*> (widget)->onButtonClicked (be);
+						if (widget->is<Clickable>()) widget->as<Clickable>()->onButtonClicked (be);
 					}
 					break;
 
@@ -436,40 +1079,41 @@ void Window::handleEvents ()
 						Widget* w = getWidgetAt 
 						(
 							p, 
-							[] (const Widget* f) {return dynamic_cast<const PointerFocusable*>(f) && dynamic_cast<const PointerFocusable*>(f)->isFocusable();},
+							[] (const Widget* f) {return f->isFocusable();},
 							[] (const Widget* f) {return f->isEventPassable(BEvents::Event::EventType::pointerFocusInEvent);}
 						);
 						if (w) w->grabDevice(BDevices::MouseButton (BDevices::MouseButton::ButtonType::none, p - w->getAbsolutePosition()));
-						if (widget->is<Pointable>()) dynamic_cast<Pointable*> (widget)->onPointerMotion (be);
+						scheduleFocus (w);
+						if (widget->is<Pointable>()) widget->as<Pointable>()->onPointerMotion (be);
 					}
 					break;
 
 				case BEvents::Event::EventType::pointerDragEvent:
 					unfocus ();
 					freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
-					if (widget->is<Draggable>()) dynamic_cast<Draggable*> (widget)->onPointerDragged(event);
+					if (widget->is<Draggable>()) widget->as<Draggable>()->onPointerDragged(event);
 					break;
 
 				case BEvents::Event::EventType::wheelScrollEvent:
 					unfocus ();
 					freeDevice (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
-					if (widget->is<Scrollable>()) dynamic_cast<Scrollable*> (widget)->onWheelScrolled(event);
+					if (widget->is<Scrollable>()) widget->as<Scrollable>()->onWheelScrolled(event);
 					break;
 
 				case BEvents::Event::EventType::valueChangedEvent:
-					if (widget->is<Valueable>()) dynamic_cast<Valueable*>(widget)->onValueChanged(event);
+					if (widget->is<Valueable>()) widget->as<Valueable>()->onValueChanged(event);
 					break;
 
 				case BEvents::Event::EventType::pointerFocusInEvent:
-					if (widget->is<PointerFocusable>()) dynamic_cast<PointerFocusable*> (widget)->onFocusIn(event);
+					if (widget->is<PointerFocusable>()) widget->as<PointerFocusable>()->onFocusIn(event);
 					break;
 
 				case BEvents::Event::EventType::pointerFocusOutEvent:
-					if (widget->is<PointerFocusable>()) dynamic_cast<PointerFocusable*> (widget)->onFocusOut(event);
+					if (widget->is<PointerFocusable>()) widget->as<PointerFocusable>()->onFocusOut(event);
 					break;
 
 				case BEvents::Event::EventType::messageEvent:
-					if (widget->is<Messagable>()) dynamic_cast<Messagable*> (widget)->onMessage (event);
+					if (widget->is<Messagable>()) widget->as<Messagable>()->onMessage (event);
 					break;
 
 				default:
@@ -480,13 +1124,147 @@ void Window::handleEvents ()
 			
 			deleteEvent (event);
 		}
+
+		// Time budget exhausted: Defer the remaining events to the next pass
+		if ((eventTimeBudget_ > 0.0) && (std::chrono::steady_clock::now() >= deadline)) break;
+	}
+
+	// Post all collected damage at the frame deadline
+	if ((frameRate_ > 0.0) && (!damage_.empty()))
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now >= frameDue_)
+		{
+			const std::chrono::steady_clock::duration interval = getFrameInterval ();
+			postDamage ();
+			postedFrame_ = true;
+			postedDue_ = frameDue_;
+
+			// Keep the frame rhythm unless we are already more than one
+			// frame behind
+			nextFrame_ = frameDue_ + interval;
+			if (nextFrame_ < now) nextFrame_ = now + interval;
+
+			// Damage not exposed until the next deadline is posted again
+			frameDue_ = nextFrame_;
+		}
+	}
+
+	// Headless: Expose the posted damage
+	if (!offscreenDamage_.empty()) exposeOffscreen ();
+}
+
+void Window::postDamage ()
+{
+	// Headless: Expose at the end of handleEvents()
+	if (!view_)
+	{
+		offscreenDamage_.add (damage_);
+		return;
+	}
+
+	// Post each area, not the bounding box
+	for (const BUtilities::Area<>& a : damage_)
+	{
+		const double x1 = std::round (a.getX() * getZoom());
+		const double y1 = std::round (a.getY() * getZoom());
+		const double x2 = std::round ((a.getX() + a.getWidth()) * getZoom());
+		const double y2 = std::round ((a.getY() + a.getHeight()) * getZoom());
+		puglPostRedisplayRect (view_,	{static_cast<PuglCoord>(x1), 
+										 static_cast<PuglCoord>(y1), 
+										 static_cast<PuglSpan>(x2 - x1), 
+										 static_cast<PuglSpan>(y2 - y1)});
 	}
 }
 
+double Window::getTimeout () const
+{
+	if (!isEventQueueEmpty()) return 0.0;
+
+	// Woken up by another thread
+	if (wakeUpPending_.load (std::memory_order_acquire)) return 0.0;
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point next = std::chrono::steady_clock::time_point::max();
+
+	// Next frame deadline
+	if ((frameRate_ > 0.0) && (!damage_.empty())) next = frameDue_;
+
+	// Next timer
+	if ((!timers_.empty()) && (timers_.begin()->first < next)) next = timers_.begin()->first;
+
+	// Next pointer focus check
+	if (focusInDue_ < next) next = focusInDue_;
+	if (focusOutDue_ < next) next = focusOutDue_;
+
+	// Next animation frame
+	if ((!animations_.empty()) && (nextAnimationFrame_ < next)) next = nextAnimationFrame_;
+
+	if (next == std::chrono::steady_clock::time_point::max()) return -1.0;	// Block until the next host event
+	if (next <= now) return 0.0;
+	return std::chrono::duration<double> (next - now).count();
+}
+
+std::chrono::steady_clock::duration Window::getFrameInterval () const
+{
+	if (frameRate_ <= 0.0) return std::chrono::steady_clock::duration::zero();
+	return std::chrono::duration_cast<std::chrono::steady_clock::duration> (std::chrono::duration<double> (1.0 / frameRate_));
+}
+
+void Window::exposeOffscreen ()
+{
+	// Expose the bounding box of the damaged region at once (like pugl
+	// coalesces posted redisplays). This results in a single frame and only
+	// the damaged region within the box is recomposited.
+	const BUtilities::Area<> a = offscreenDamage_.getArea();
+	offscreenDamage_ = BUtilities::Region<> ();
+	const double x1 = std::floor (a.getX() * getZoom());
+	const double y1 = std::floor (a.getY() * getZoom());
+	const double x2 = std::ceil ((a.getX() + a.getWidth()) * getZoom());
+	const double y2 = std::ceil ((a.getY() + a.getHeight()) * getZoom());
+	if ((x2 <= x1) || (y2 <= y1)) return;
+
+	PuglEvent event {};
+	event.expose.type = PUGL_EXPOSE;
+	event.expose.x = static_cast<PuglCoord> (x1);
+	event.expose.y = static_cast<PuglCoord> (y1);
+	event.expose.width = static_cast<PuglSpan> (x2 - x1);
+	event.expose.height = static_cast<PuglSpan> (y2 - y1);
+	translateEvent (&event);
+}
+
 PuglStatus Window::translatePuglEvent (PuglView* view, const PuglEvent* puglEvent)
 {
 	Window* w = (Window*) puglGetHandle (view);
 	if (!w) return PUGL_BAD_PARAMETER;
+	return w->translateEvent (puglEvent);
+}
+
+PuglStatus Window::translateEvent (const PuglEvent* puglEvent)
+{
+	Window* w = this;
+
+	if (w->recorder_.isOpen()) w->recorder_.record (*puglEvent);
+
+	// Input latency is measured from the first host input event after the
+	// last presentation
+	if 
+	(
+		(!w->inputPending_) &&
+		(
+			(puglEvent->type == PUGL_KEY_PRESS) ||
+			(puglEvent->type == PUGL_KEY_RELEASE) ||
+			(puglEvent->type == PUGL_TEXT) ||
+			(puglEvent->type == PUGL_BUTTON_PRESS) ||
+			(puglEvent->type == PUGL_BUTTON_RELEASE) ||
+			(puglEvent->type == PUGL_MOTION) ||
+			(puglEvent->type == PUGL_SCROLL)
+		)
+	)
+	{
+		w->inputPending_ = true;
+		w->inputTime_ = std::chrono::steady_clock::now();
+	}
 
 	switch (puglEvent->type) {
 
@@ -771,6 +1549,9 @@ PuglStatus Window::translatePuglEvent (PuglView* view, const PuglEvent* puglEven
 	// Expose events handled HERE
 	case PUGL_EXPOSE:
 		{
+			BUTILITIES_TRACE_SCOPE ("expose", "expose");
+			BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::compositePhase, &w->allocationSink_);
+
 			// Calculate the non-zoomed area from the event data
 			BUtilities::Area<> area = BUtilities::Area<>	(puglEvent->expose.x / w->getZoom(), 
 															 puglEvent->expose.y / w->getZoom(), 
@@ -781,44 +1562,105 @@ PuglStatus Window::translatePuglEvent (PuglView* view, const PuglEvent* puglEven
 			cairo_t* crw = w->getCairoContext ();
 			if (crw && (cairo_status (crw) == CAIRO_STATUS_SUCCESS))
 			{
-				// Create a temporary window surface
-				cairo_surface_t* windowSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, w->getWidth() , w->getHeight());
+				// Get access to the retained surfaces. Newly created surfaces
+				// don't contain anything. Thus, the whole window is exposed.
+				// Otherwise, only the damaged parts of the exposed area need
+				// to be recomposited. The rest of the retained window surface
+				// is still valid.
+				const BUtilities::Area<> windowArea (0, 0, std::ceil (w->getWidth() * w->getSurfaceScale()) / w->getSurfaceScale(), std::ceil (w->getHeight() * w->getSurfaceScale()) / w->getSurfaceScale());
+				BUtilities::Region<> region;
+				if (w->validateSurfaces ())
+				{
+					region = BUtilities::Region<> (windowArea);
+					w->damage_.clear();
+				}
+
+				else
+				{
+					region = w->damage_;
+					region.intersect (area);
+					w->damage_.subtract (area);
+				}
+
+				cairo_surface_t* windowSurface = w->windowSurface_;
 				if (windowSurface && (cairo_surface_status (windowSurface) == CAIRO_STATUS_SUCCESS))
 				{
-					//Get access to the temporary window surface
-					cairo_t* cr = cairo_create(windowSurface);
-					if (cr && (cairo_status (cr) == CAIRO_STATUS_SUCCESS))
+					if (!region.empty())
 					{
-						// Get a map of layered surfaces for the selected area
-						std::map<int,cairo_surface_t*> storageSurfaces;
-						w->display (storageSurfaces, BUtilities::Point<> (w->getWidth(), w->getHeight()), area);
+						w->addDamageStatistics (region);
 
-						// Write all layered surfaces to the temporary window surface from back to front
-						for (std::map<int,cairo_surface_t*>::reverse_iterator rit = storageSurfaces.rbegin(); rit != storageSurfaces.rend(); ++rit)
+						// The layered surfaces are retained too and cover the
+						// whole window. Thus, only the damaged region needs
+						// to be cleared and redrawn in the layered surfaces.
+						const BUtilities::Area<> box = windowArea;
+
+						// Clear the region in all layered surfaces
 						{
-							cairo_surface_t* s = rit->second;
-							if (s && (cairo_surface_status (s) == CAIRO_STATUS_SUCCESS))
+							BUTILITIES_TRACE_SCOPE ("expose", "clear");
+							for (std::map<int,cairo_surface_t*>::iterator it = w->layerSurfaces_.begin(); it != w->layerSurfaces_.end(); ++it)
 							{
-								cairo_save (cr);
-								cairo_set_source_surface (cr, s, 0.0, 0.0);
-								cairo_paint (cr);
-								cairo_restore (cr);
-								cairo_surface_destroy(s);
+								cairo_t* crl = cairo_create (it->second);
+								if (crl && (cairo_status (crl) == CAIRO_STATUS_SUCCESS))
+								{
+									for (const BUtilities::Area<>& a : region) cairo_rectangle (crl, a.getX() - box.getX(), a.getY() - box.getY(), a.getWidth(), a.getHeight());
+									cairo_clip (crl);
+									cairo_set_operator (crl, CAIRO_OPERATOR_CLEAR);
+									cairo_paint (crl);
+								}
+								cairo_destroy (crl);
 							}
 						}
 
-						cairo_destroy (cr);	
+						// Update the layered surfaces for the selected region
+						{
+							BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::drawPhase, &w->allocationSink_);
+							if (w->parallelDraw_) w->drawParallel (region);
+							w->display (w->layerSurfaces_, box, region);
+						}
+
+						// Recomposite the retained window surface
+						{
+							BUTILITIES_TRACE_SCOPE ("expose", "composite");
+							const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+							if (w->parallelComposite_) w->compositeTiled (region, box);
+							else w->composite (region, box);
+							w->statistics_.compositeTime += std::chrono::duration<double> (std::chrono::steady_clock::now() - t0).count();
+						}
 					}
 
-					// Write temporary window surface to the host provided surface
+					// Write the window surface to the host provided surface, but
+					// only within the exposed area. With zoomed surfaces, the
+					// window surface already has got the zoomed resolution
+					// (device scale). Thus, it is copied 1:1. Otherwise, it is
+					// scaled by the zoom factor.
+					BUTILITIES_TRACE_SCOPE ("expose", "present");
 					cairo_save (crw);
+					cairo_rectangle (crw, puglEvent->expose.x, puglEvent->expose.y, puglEvent->expose.width, puglEvent->expose.height);
+					cairo_clip (crw);
 					cairo_scale (crw, w->getZoom(), w->getZoom());
 					cairo_set_source_surface (crw, windowSurface, 0.0, 0.0);
 					cairo_paint (crw);
 					cairo_restore (crw);
-					cairo_surface_destroy (windowSurface);
+
+					if (w->debugDamage_)
+					{
+						cairo_save (crw);
+						cairo_rectangle (crw, puglEvent->expose.x, puglEvent->expose.y, puglEvent->expose.width, puglEvent->expose.height);
+						cairo_clip (crw);
+						w->paintDebugDamage (crw, region);
+						cairo_restore (crw);
+					}
 				}
 			}
+
+			// Frame presented later than the next deadline?
+			if (w->postedFrame_)
+			{
+				if (std::chrono::steady_clock::now() > w->postedDue_ + w->getFrameInterval()) ++w->missedFrames_;
+				w->postedFrame_ = false;
+			}
+
+			w->finishFrameStatistics ();
 		}
 		break;
 
@@ -833,6 +1675,443 @@ PuglStatus Window::translatePuglEvent (PuglView* view, const PuglEvent* puglEven
 	return PUGL_SUCCESS;
 }
 
+bool Window::validateSurfaces ()
+{
+	const double scale = getSurfaceScale();
+	const int width = std::ceil (getWidth() * scale);
+	const int height = std::ceil (getHeight() * scale);
+	double sx = 0.0;
+	double sy = 0.0;
+	if (windowSurface_) cairo_surface_get_device_scale (windowSurface_, &sx, &sy);
+
+	if
+	(
+		windowSurface_ && 
+		(cairo_surface_status (windowSurface_) == CAIRO_STATUS_SUCCESS) &&
+		(cairo_image_surface_get_width (windowSurface_) == width) &&
+		(cairo_image_surface_get_height (windowSurface_) == height) &&
+		(sx == scale)
+	) return false;
+
+	// Extends or zoom changed: Drop all retained surfaces. Layered surfaces
+	// are re-created on demand by display().
+	destroySurfaces ();
+	windowSurface_ = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+	cairo_surface_set_device_scale (windowSurface_, scale, scale);
+	addSurfaceStatistics (windowSurface_);
+	return true;
+}
+
+void Window::destroySurfaces ()
+{
+	for (std::map<int,cairo_surface_t*>::iterator it = layerSurfaces_.begin(); it != layerSurfaces_.end(); ++it)
+	{
+		if (it->second) cairo_surface_destroy (it->second);
+	}
+	layerSurfaces_.clear();
+
+	if (windowSurface_) 
+	{
+		cairo_surface_destroy (windowSurface_);
+		windowSurface_ = nullptr;
+	}
+}
+
+void Window::composite (const BUtilities::Region<>& region, const BUtilities::Area<>& box)
+{
+	//Get access to the retained window surface
+	cairo_t* cr = cairo_create (windowSurface_);
+	if (cr && (cairo_status (cr) == CAIRO_STATUS_SUCCESS))
+	{
+		// Recomposite only the selected region
+		for (const BUtilities::Area<>& a : region) cairo_rectangle (cr, a.getX(), a.getY(), a.getWidth(), a.getHeight());
+		cairo_clip (cr);
+		cairo_save (cr);
+		cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (cr);
+		cairo_restore (cr);
+
+		// Write all layered surfaces to the window surface from back to front
+		for (std::map<int,cairo_surface_t*>::reverse_iterator rit = layerSurfaces_.rbegin(); rit != layerSurfaces_.rend(); ++rit)
+		{
+			cairo_surface_t* s = rit->second;
+			if (s && (cairo_surface_status (s) == CAIRO_STATUS_SUCCESS))
+			{
+				cairo_save (cr);
+				cairo_set_source_surface (cr, s, box.getX(), box.getY());
+				cairo_paint (cr);
+				cairo_restore (cr);
+			}
+		}
+	}
+	cairo_destroy (cr);
+}
+
+void Window::compositeTiled (const BUtilities::Region<>& region, const BUtilities::Area<>& box)
+{
+	// Split the region into tiles of pixels of the window surface
+	const double zoom = getSurfaceScale();
+	const int winWidth = cairo_image_surface_get_width (windowSurface_);
+	const int winHeight = cairo_image_surface_get_height (windowSurface_);
+	const int bx = std::lround (box.getX() * zoom);
+	const int by = std::lround (box.getY() * zoom);
+	std::vector<BUtilities::Area<int>> tiles;
+	for (const BUtilities::Area<>& a : region)
+	{
+		const int x1 = std::max (static_cast<int> (std::lround (a.getX() * zoom)), 0);
+		const int y1 = std::max (static_cast<int> (std::lround (a.getY() * zoom)), 0);
+		const int x2 = std::min (static_cast<int> (std::lround ((a.getX() + a.getWidth()) * zoom)), winWidth);
+		const int y2 = std::min (static_cast<int> (std::lround ((a.getY() + a.getHeight()) * zoom)), winHeight);
+		for (int y = y1; y < y2; y += BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE)
+		{
+			for (int x = x1; x < x2; x += BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE)
+			{
+				tiles.push_back	(BUtilities::Area<int> 	(x, y, 
+														 std::min (BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE, x2 - x), 
+														 std::min (BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE, y2 - y)));
+			}
+		}
+	}
+
+	// Collect the layered surfaces from back to front
+	std::vector<cairo_surface_t*> layers;
+	for (std::map<int,cairo_surface_t*>::reverse_iterator rit = layerSurfaces_.rbegin(); rit != layerSurfaces_.rend(); ++rit)
+	{
+		cairo_surface_t* s = rit->second;
+		if (s && (cairo_surface_status (s) == CAIRO_STATUS_SUCCESS))
+		{
+			cairo_surface_flush (s);
+			layers.push_back (s);
+		}
+	}
+
+	// Blend each tile on a worker thread. The tiles don't overlap and each 
+	// thread only uses its own Cairo surfaces pointing to the shared pixel
+	// data.
+	cairo_surface_flush (windowSurface_);
+	unsigned char* winData = cairo_image_surface_get_data (windowSurface_);
+	const int winStride = cairo_image_surface_get_stride (windowSurface_);
+	getThreadPool().run (tiles.size(), [this, &tiles, &layers, winData, winStride, bx, by] (const size_t i)
+	{
+		BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::compositePhase, &allocationSink_);
+		const BUtilities::Area<int>& t = tiles[i];
+		cairo_surface_t* dst = cairo_image_surface_create_for_data	(winData + t.getY() * winStride + 4 * t.getX(),
+																	 CAIRO_FORMAT_ARGB32, t.getWidth(), t.getHeight(), winStride);
+		cairo_t* cr = cairo_create (dst);
+		if (cr && (cairo_status (cr) == CAIRO_STATUS_SUCCESS))
+		{
+			cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+			cairo_paint (cr);
+			cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+
+			for (cairo_surface_t* s : layers)
+			{
+				// Layer pixels covered by this tile
+				const int lx = t.getX() - bx;
+				const int ly = t.getY() - by;
+				const int lw = std::min (t.getWidth(), cairo_image_surface_get_width (s) - lx);
+				const int lh = std::min (t.getHeight(), cairo_image_surface_get_height (s) - ly);
+				if ((lx < 0) || (ly < 0) || (lw <= 0) || (lh <= 0)) continue;
+
+				const int stride = cairo_image_surface_get_stride (s);
+				cairo_surface_t* src = cairo_image_surface_create_for_data	(cairo_image_surface_get_data (s) + ly * stride + 4 * lx,
+																			 CAIRO_FORMAT_ARGB32, lw, lh, stride);
+				cairo_set_source_surface (cr, src, 0.0, 0.0);
+				cairo_paint (cr);
+				cairo_surface_destroy (src);
+			}
+		}
+		cairo_destroy (cr);
+		cairo_surface_destroy (dst);
+	});
+	cairo_surface_mark_dirty (windowSurface_);
+}
+
+BUtilities::ThreadPool& Window::getThreadPool ()
+{
+	if (!threadPool_) threadPool_.reset (new BUtilities::ThreadPool ());
+	return *threadPool_;
+}
+
+void Window::drawParallel (const BUtilities::Region<>& region)
+{
+	BUTILITIES_TRACE_SCOPE ("draw", "drawParallel");
+
+	// Collect all visible widgets to be drawn within the region
+	std::vector<Widget*> widgets;
+	forEachChild ([&widgets, &region] (Linkable* l)
+	{
+		Widget* w = dynamic_cast<Widget*>(l);
+		if (!(w && w->isVisualizable())) return false;
+		if (w->scheduleDraw_ && w->isConcurrentDrawable() && region.overlaps (w->getAbsoluteArea())) 
+		{
+			// Fill the geometry cache before. The worker threads only read.
+			w->isVisible();
+			w->getLayer();
+			widgets.push_back (w);
+		}
+		return true;
+	});
+
+	// Draw (and rasterize) in parallel. Each widget only draws to its own
+	// surface.
+	const double zoom = getSurfaceScale();
+	std::vector<std::chrono::steady_clock::duration> times (widgets.size());
+	getThreadPool().run (widgets.size(), [this, &widgets, &times, zoom] (const size_t i)
+	{
+		BUTILITIES_ALLOCATION_SCOPE (BUtilities::AllocationCounter::drawPhase, &allocationSink_);
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		{
+			BUTILITIES_TRACE_SCOPE ("draw", BUtilities::Trace::getTypeName (typeid (*widgets[i])));
+			widgets[i]->draw();
+		}
+		times[i] = std::chrono::steady_clock::now() - t0;
+		widgets[i]->rasterize (zoom);
+	});
+
+	for (size_t i = 0; i < widgets.size(); ++i) addDrawStatistics (widgets[i], times[i]);
+}
+
+void Window::processCrossThreadItems ()
+{
+	// Take all items available now (no allocation, capacity reserved)
+	crossThreadItems_.clear();
+	CrossThreadItem item;
+	bool drained = true;
+	while (crossThreadItems_.size() < crossThreadItems_.capacity())
+	{
+		if (!crossThreadQueue_.pop (item)) break;
+		crossThreadItems_.push_back (item);
+		drained = (crossThreadItems_.size() < crossThreadItems_.capacity());
+	}
+
+	// Drop items for widgets released after posting. All items posted before
+	// the release have got an older (or the same) generation.
+	if (!crossThreadReleased_.empty())
+	{
+		for (CrossThreadItem& i : crossThreadItems_)
+		{
+			for (const std::pair<Widget*, uint64_t>& r : crossThreadReleased_)
+			{
+				if ((i.widget == r.first) && (i.generation <= r.second)) i.apply = nullptr;
+			}
+		}
+
+		// Queue empty: All released widgets are handled
+		if (drained) crossThreadReleased_.clear();
+	}
+
+	// Items left: Continue with the next call
+	if (!drained) wakeUpPending_.store (true, std::memory_order_release);
+	if (crossThreadItems_.empty()) return;
+
+	// Last value wins: Mark all but the last value for each widget
+	crossThreadValues_.clear();
+	for (size_t i = 0; i < crossThreadItems_.size(); ++i)
+	{
+		if ((crossThreadItems_[i].kind == CrossThreadKind::value) && crossThreadItems_[i].apply) crossThreadValues_.emplace_back (crossThreadItems_[i].widget, i);
+	}
+	std::sort (crossThreadValues_.begin(), crossThreadValues_.end());
+	for (size_t i = 0; i + 1 < crossThreadValues_.size(); ++i)
+	{
+		if (crossThreadValues_[i].first == crossThreadValues_[i + 1].first) crossThreadItems_[crossThreadValues_[i].second].apply = nullptr;
+	}
+
+	// Apply in order
+	for (CrossThreadItem& i : crossThreadItems_)
+	{
+		if (i.apply) i.apply (this, i.widget, i.name, i.data);
+	}
+}
+
+void Window::wakeUp ()
+{
+	if (wakeUpPending_.exchange (true, std::memory_order_acq_rel)) return;
+
+	if (view_)
+	{
+		PuglEvent event {};
+		event.client.type = PUGL_CLIENT;
+		event.client.data1 = reinterpret_cast<uintptr_t> (this);
+		puglSendEvent (view_, &event);
+	}
+
+	// Headless: Lock to not notify between the test and the wait in 
+	// waitForEvents()
+	else
+	{
+		{
+			std::lock_guard<std::mutex> lock (wakeUpMutex_);
+		}
+		wakeUpCondition_.notify_one ();
+	}
+}
+
+void Window::purgeCrossThreadItems (Widget* widget)
+{
+	if (!(widget && crossThreadUsed_.load (std::memory_order_relaxed))) return;
+
+	// Items already taken (e.g., if released by a callback of an item)
+	for (CrossThreadItem& i : crossThreadItems_)
+	{
+		if (i.widget == widget) i.apply = nullptr;
+	}
+
+	// Items posted until now have got a generation <= this generation
+	crossThreadReleased_.emplace_back (widget, crossThreadGeneration_.fetch_add (1, std::memory_order_acq_rel));
+}
+
+void Window::addMessage (Widget* widget, const char* name, const BUtilities::Any& content)
+{
+	if (widget && widget->is<Messagable>()) addEventToQueue (new BEvents::MessageEvent (widget, (name ? name : ""), content));
+}
+
+uint32_t Window::addTimer (const double seconds, std::function<void ()> func, const bool periodic)
+{
+	const std::chrono::steady_clock::duration interval = std::chrono::duration_cast<std::chrono::steady_clock::duration> (std::chrono::duration<double> (std::max (seconds, 0.0)));
+	const uint32_t id = ++timerCount_;
+	timerIndex_[id] = timers_.emplace (std::chrono::steady_clock::now() + interval, Timer {id, interval, periodic, func});
+	wakeUp ();
+	return id;
+}
+
+void Window::removeTimer (const uint32_t id)
+{
+	// Timer currently called: Don't re-schedule
+	if (id == processedTimer_)
+	{
+		processedTimer_ = 0;
+		return;
+	}
+
+	std::unordered_map<uint32_t, TimerMap::iterator>::iterator it = timerIndex_.find (id);
+	if (it == timerIndex_.end()) return;
+	timers_.erase (it->second);
+	timerIndex_.erase (it);
+}
+
+uint32_t Window::addAnimation (std::function<bool (const double seconds)> func)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (animations_.empty()) nextAnimationFrame_ = now;
+	const uint32_t id = ++timerCount_;
+	animations_[id] = Animation {now, func, false};
+	wakeUp ();
+	return id;
+}
+
+void Window::removeAnimation (const uint32_t id)
+{
+	// Animations called right now are only marked and erased after the 
+	// frame
+	if (processingAnimations_)
+	{
+		std::map<uint32_t, Animation>::iterator it = animations_.find (id);
+		if (it != animations_.end()) it->second.removed = true;
+	}
+
+	else animations_.erase (id);
+}
+
+void Window::processTimers ()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	// Only process timers due now. Callbacks may add or remove timers.
+	while ((!timers_.empty()) && (timers_.begin()->first <= now))
+	{
+		// Take the node out of the map, thus it can be re-inserted without
+		// copying or allocation
+		TimerMap::node_type node = timers_.extract (timers_.begin());
+		const uint32_t id = node.mapped().id;
+		processedTimer_ = id;
+		if (node.mapped().func) node.mapped().func ();
+
+		// Re-schedule periodic timers unless they removed themselves. Skip
+		// missed periods.
+		if 
+		(
+			(processedTimer_ == id) && 
+			node.mapped().periodic && 
+			(node.mapped().interval > std::chrono::steady_clock::duration::zero())
+		)
+		{
+			std::chrono::steady_clock::time_point next = node.key() + node.mapped().interval;
+			if (next <= now) next = now + node.mapped().interval;
+			node.key() = next;
+			timerIndex_[id] = timers_.insert (std::move (node));
+		}
+
+		else timerIndex_.erase (id);
+		processedTimer_ = 0;
+	}
+}
+
+void Window::processAnimations ()
+{
+	if (animations_.empty()) return;
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now < nextAnimationFrame_) return;
+
+	// Call all animations once per frame. Callbacks may add or remove
+	// animations. Removed animations are erased after the frame.
+	processingAnimations_ = true;
+	for (std::map<uint32_t, Animation>::iterator it = animations_.begin(); it != animations_.end(); ++it)
+	{
+		if (it->second.removed || (it->second.start > now)) continue;
+		const double t = std::chrono::duration<double> (now - it->second.start).count();
+		if (it->second.func && (!it->second.func (t))) it->second.removed = true;
+	}
+	processingAnimations_ = false;
+
+	for (std::map<uint32_t, Animation>::iterator it = animations_.begin(); it != animations_.end(); /* empty */)
+	{
+		if (it->second.removed) it = animations_.erase (it);
+		else ++it;
+	}
+
+	const std::chrono::steady_clock::duration interval = 
+	(
+		frameRate_ > 0.0 ? 
+		getFrameInterval () : 
+		std::chrono::duration_cast<std::chrono::steady_clock::duration> (std::chrono::duration<double> (1.0 / BWIDGETS_DEFAULT_FRAME_RATE))
+	);
+	nextAnimationFrame_ += interval;
+	if (nextAnimationFrame_ <= now) nextAnimationFrame_ = now + interval;
+}
+
+void Window::scheduleFocus (Widget* widget)
+{
+	focusInDue_ = std::chrono::steady_clock::time_point::max();
+	focusOutDue_ = std::chrono::steady_clock::time_point::max();
+
+	const PointerFocusable* focus = dynamic_cast<const PointerFocusable*> (widget);
+	if (!(focus && focus->isFocusable())) return;
+
+	// Check for focus in and focus out at the respective times
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	focusInDue_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration> (focus->getFocusInMilliseconds());
+	focusOutDue_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration> (focus->getFocusOutMilliseconds());
+}
+
+void Window::processFocus ()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if (focusInDue_ <= now)
+	{
+		focusInDue_ = std::chrono::steady_clock::time_point::max();
+		translateTimeEvent ();
+	}
+
+	if (focusOutDue_ <= now)
+	{
+		focusOutDue_ = std::chrono::steady_clock::time_point::max();
+		translateTimeEvent ();
+	}
+}
+
 void Window::translateTimeEvent ()
 {
 	std::list<Widget*> gwidgets = listDeviceGrabbed (BDevices::MouseButton (BDevices::MouseButton::ButtonType::none));
@@ -893,33 +2172,24 @@ void Window::unfocus ()
 
 void Window::purgeEventQueue (Widget* widget)
 {
-	for (std::list<BEvents::Event*>::iterator it = eventQueue_.begin (); it != eventQueue_.end (); /* empty */)
+	// Nullptr = joker
+	if (!widget)
 	{
-		BEvents::Event* event = *it;
-		if
-		(
-			(event) &&
-			(
-				// Nullptr = joker
-				(widget == nullptr) ||
-				// Hit
-				(widget == event->getWidget ()) ||
-				(
-					// Hit in request widgets
-					(
-						(static_cast<uint32_t>(event->getEventType ()) & static_cast<uint32_t>(BEvents::Event::EventType::configureRequestEvent)) ||
-						(static_cast<uint32_t>(event->getEventType ()) & static_cast<uint32_t>(BEvents::Event::EventType::exposeRequestEvent)) ||
-						(static_cast<uint32_t>(event->getEventType ()) & static_cast<uint32_t>(BEvents::Event::EventType::closeRequestEvent))
-					) &&
-					(widget == ((BEvents::WidgetEvent*)event)->getRequestWidget ())
-				)
-			)
-		)
-		{
-			it = eventQueue_.erase (it);
-			delete event;
-		}
-		else ++it;
+		while (BEvents::Event* event = popEvent ()) delete event;
+		return;
+	}
+
+	// Only remove the events linked to the widget
+	while (BEvents::Event* event = widget->queuedEventsFront_)
+	{
+		popEvent (event);
+		delete event;
+	}
+
+	while (BEvents::Event* event = widget->requestEventsFront_)
+	{
+		popEvent (event);
+		delete event;
 	}
 }
 
@@ -21,9 +21,29 @@
 // Default BWidgets::Window settings (Note: use non-transparent backgrounds only)
 #define BWIDGETS_DEFAULT_WINDOW_BACKGROUND BStyles::blackFill
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 #include "Widget.hpp"
+#include "EventRecorder.hpp"
 #include "pugl/pugl.h"
+#include "../BUtilities/Region.hpp"
+#include "../BUtilities/ThreadPool.hpp"
+#include "../BUtilities/MpscQueue.hpp"
+#include "../BUtilities/Any.hpp"
+#include "../BUtilities/AllocationCounter.hpp"
 #include "Supports/Closeable.hpp"
 #include "Supports/EventQueueable.hpp"
 
@@ -35,9 +55,39 @@
 #define BWIDGETS_DEFAULT_WINDOW_HEIGHT 400
 #endif
 
+#ifndef BWIDGETS_DEFAULT_MAX_DAMAGE_AREAS
+#define BWIDGETS_DEFAULT_MAX_DAMAGE_AREAS 16
+#endif
+
+#ifndef BWIDGETS_DEFAULT_FRAME_RATE
+#define BWIDGETS_DEFAULT_FRAME_RATE 60.0
+#endif
+
+#ifndef BWIDGETS_DEFAULT_EVENT_TIME_BUDGET
+#define BWIDGETS_DEFAULT_EVENT_TIME_BUDGET 0.008
+#endif
+
+#ifndef BWIDGETS_DEFAULT_CROSS_THREAD_QUEUE_SIZE
+#define BWIDGETS_DEFAULT_CROSS_THREAD_QUEUE_SIZE 1024
+#endif
+
+#ifndef BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE
+#define BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE 32
+#endif
+
+#ifndef BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE
+#define BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE 128
+#endif
+
+#ifndef BWIDGETS_DEFAULT_HIT_INDEX_CELL_SIZE
+#define BWIDGETS_DEFAULT_HIT_INDEX_CELL_SIZE 32.0
+#endif
+
 namespace BWidgets
 {
 
+template <class T> class ValueableTyped;
+
 /**
  *  @brief  Main %Window class of BWidgets.
  *
@@ -64,15 +114,180 @@ namespace BWidgets
  */
 class Window : public Widget, public EventQueueable, public Closeable
 {
+	friend class Widget;
+
+public:
+
+	/**
+	 *  @brief  Draw statistics of a widget class.
+	 */
+	struct DrawStatistics
+	{
+		unsigned long count;	// Number of draw() calls
+		double time;			// Time spent in draw() in seconds
+	};
+
+	/**
+	 *  @brief  Statistics of a recomposited area.
+	 */
+	struct DamageStatistics
+	{
+		BUtilities::Area<> area;	// Recomposited area (not zoomed)
+		size_t pixels;				// Number of recomposited window surface pixels
+	};
+
+	/**
+	 *  @brief  Performance statistics of a single frame.
+	 *
+	 *  A frame spans all work done from the end of the previous 
+	 *  presentation (host expose) to the end of this presentation.
+	 */
+	struct FrameStatistics
+	{
+		unsigned long frame;					// Frame number
+		std::array<unsigned long, 16> events;	// Handled events by event type bit
+		unsigned long mergedEvents;				// Events merged into queued events
+		size_t maxQueueSize;					// Maximum event queue depth
+		unsigned long drawnWidgets;				// Number of widget draw() calls
+		double drawTime;						// Time spent in widget draw() in seconds
+		std::map<std::type_index, DrawStatistics> classDrawStatistics;	// Draws by widget class
+		double compositeTime;					// Time spent for compositing in seconds
+		size_t surfaceBytes;					// Bytes of newly allocated window and layer surfaces
+		std::vector<DamageStatistics> damage;	// Recomposited areas
+		size_t damagePixels;					// Number of all recomposited window surface pixels
+		std::array<BUtilities::AllocationCounter::Statistics, BUtilities::AllocationCounter::nrPhases> allocations;	// Allocations by phase (only with BUTILITIES_ALLOCATION_COUNTER)
+		double inputLatency;					// Time from the first host input event to the presentation in seconds or -1.0 if no input
+	};
+
+	/**
+	 *  @brief  %Window backends.
+	 *
+	 *  A %Window either uses a Pugl view provided by the windowing system
+	 *  (BackendType::pugl) or renders into an offscreen Cairo image surface
+	 *  without any windowing system (BackendType::headless).
+	 */
+	enum class BackendType
+	{
+		pugl,
+		headless
+	};
+
 protected:
 	double zoom_;
+	BackendType backend_;
 	PuglWorld* world_;
 	PuglWorldType worldType_;
 	PuglView* view_;
 	PuglNativeView nativeWindow_;
+	cairo_surface_t* offscreenSurface_;
+	cairo_t* offscreenContext_;
+	BUtilities::Region<> offscreenDamage_;
 	bool quit_;
 	bool focused_;
 	BUtilities::Point<> pointer_;
+	std::map<int, cairo_surface_t*> layerSurfaces_;
+	cairo_surface_t* windowSurface_;
+	BUtilities::Region<> damage_;
+	bool zoomedSurfaces_;
+	bool parallelDraw_;
+	bool parallelComposite_;
+	std::unique_ptr<BUtilities::ThreadPool> threadPool_;
+	double frameRate_;
+	std::chrono::steady_clock::time_point nextFrame_;
+	std::chrono::steady_clock::time_point frameDue_;
+	std::chrono::steady_clock::time_point postedDue_;
+	bool postedFrame_;
+	unsigned long missedFrames_;
+	double eventTimeBudget_;
+
+	struct Timer
+	{
+		uint32_t id;
+		std::chrono::steady_clock::duration interval;
+		bool periodic;
+		std::function<void ()> func;
+	};
+
+	struct Animation
+	{
+		std::chrono::steady_clock::time_point start;
+		std::function<bool (const double seconds)> func;
+		bool removed;
+	};
+
+	typedef std::multimap<std::chrono::steady_clock::time_point, Timer> TimerMap;
+	TimerMap timers_;
+	std::unordered_map<uint32_t, TimerMap::iterator> timerIndex_;
+	uint32_t processedTimer_;
+	std::map<uint32_t, Animation> animations_;
+	bool processingAnimations_;
+	uint32_t timerCount_;
+	std::chrono::steady_clock::time_point nextAnimationFrame_;
+	std::chrono::steady_clock::time_point focusInDue_;
+	std::chrono::steady_clock::time_point focusOutDue_;
+
+	enum class CrossThreadKind
+	{
+		value,
+		message
+	};
+
+	struct CrossThreadItem
+	{
+		CrossThreadKind kind;
+		Widget* widget;
+		uint64_t generation;
+		const char* name;
+		void (*apply) (Window* window, Widget* widget, const char* name, const void* data);
+		alignas (std::max_align_t) unsigned char data[BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE];
+	};
+
+	BUtilities::MpscQueue<CrossThreadItem> crossThreadQueue_;
+	std::atomic<bool> crossThreadUsed_;
+	std::atomic<bool> wakeUpPending_;
+	std::mutex wakeUpMutex_;
+	std::condition_variable wakeUpCondition_;
+	std::atomic<uint64_t> crossThreadGeneration_;
+	std::vector<CrossThreadItem> crossThreadItems_;
+	std::vector<std::pair<Widget*, size_t>> crossThreadValues_;
+	std::vector<std::pair<Widget*, uint64_t>> crossThreadReleased_;
+
+	struct DeviceLess
+	{
+		typedef void is_transparent;
+		bool operator() (const std::unique_ptr<BDevices::Device>& lhs, const std::unique_ptr<BDevices::Device>& rhs) const {return *lhs < *rhs;}
+		bool operator() (const std::unique_ptr<BDevices::Device>& lhs, const BDevices::Device& rhs) const {return *lhs < rhs;}
+		bool operator() (const BDevices::Device& lhs, const std::unique_ptr<BDevices::Device>& rhs) const {return lhs < *rhs;}
+	};
+
+	std::map<std::unique_ptr<BDevices::Device>, std::vector<Widget*>, DeviceLess> deviceGrabs_;
+
+	struct HitEntry
+	{
+		Widget* widget;
+		BUtilities::Area<> area;
+		size_t parent;
+	};
+
+	bool hitIndexValid_;
+	std::vector<HitEntry> hitEntries_;
+	size_t hitColumns_;
+	size_t hitRows_;
+	std::vector<size_t> hitCellStart_;
+	std::vector<size_t> hitCellEntries_;
+	std::vector<uint32_t> hitMarks_;
+	uint32_t hitStamp_;
+	std::vector<size_t> hitPath_;
+	std::vector<std::pair<size_t, Widget*>> hitStack_;
+
+	FrameStatistics statistics_;
+	FrameStatistics frameStatistics_;
+	bool inputPending_;
+	std::chrono::steady_clock::time_point inputTime_;
+	BUtilities::AllocationCounter::Sink allocationSink_;
+	EventRecorder recorder_;
+	bool debugDamage_;
+	std::vector<BUtilities::Area<>> debugDrawnAreas_;
 
 public:
 
@@ -104,6 +319,24 @@ public:
 		uint32_t urid = BUTILITIES_URID_UNKNOWN_URID, std::string title = "BWidgets", bool resizable = false,
 		PuglWorldType worldType = PUGL_PROGRAM, int worldFlag = 0);
 
+	/**
+	 *  @brief  Construct a %Window object with a selected backend.
+	 *  @param width  Window width.
+	 *  @param height  Window height.
+	 *  @param backend  BackendType.
+	 *  @param urid  Optional, URID (default = BUTILITIES_URID_UNKNOWN_URID).
+	 *  @param title  Optional, Window title.
+	 *
+	 *  A headless %Window (BackendType::headless) doesn't create any Pugl 
+	 *  world or view. It renders into an offscreen Cairo image surface (see 
+	 *  @c getOffscreenSurface() ) and only receives synthetic host events 
+	 *  (see @c injectEvent() ). Event handling, drawing, and compositing use 
+	 *  the same pipeline as the Pugl backend. Exposes are performed at the 
+	 *  end of each @c handleEvents() call.
+	 */
+	Window	(const double width, const double height, const BackendType backend,
+			 uint32_t urid = BUTILITIES_URID_UNKNOWN_URID, std::string title = "BWidgets");
+
 	virtual ~Window ();
 
 	/**
@@ -126,6 +359,9 @@ public:
 	 * 
 	 * @param device  Device
 	 * @return  List of all widgets with device grabbed
+	 *
+	 * The %Window keeps a registry of all grabbed devices. Thus, the list is
+	 * taken up without scanning all linked widgets.
 	 */
 	std::list<Widget*> listDeviceGrabbed (const BDevices::Device& device) const;
 
@@ -141,6 +377,224 @@ public:
 	 */
 	double getZoom () const;
 
+	/**
+	 *  @brief  Switches zoomed resolution of the retained surfaces on/off.
+	 *  @param status  True if on, otherwise false (default).
+	 *
+	 *  If off, the window surface and the layered surfaces have got the
+	 *  unzoomed size and the result is scaled by the zoom factor on
+	 *  presentation. If on, these surfaces have got the zoomed resolution.
+	 *  Then widgets in retained mode (see @c Visualizable::setRetained() )
+	 *  are rasterized at the zoom factor and shown sharp. This costs zoom²
+	 *  times the memory and blending bandwidth.
+	 */
+	virtual void setZoomedSurfaces (const bool status);
+
+	/**
+	 *  @brief  Information about zoomed resolution of the retained surfaces.
+	 *  @return  True if on, otherwise false.
+	 */
+	bool isZoomedSurfaces () const;
+
+	/**
+	 *  @brief  Gets the scale of the retained surfaces.
+	 *  @return  Zoom factor if zoomed surfaces are on, otherwise 1.0.
+	 */
+	double getSurfaceScale () const;
+
+	/**
+	 *  @brief  Sets the target frame rate.
+	 *  @param fps  Frames per second or 0.0 for unpaced redraw.
+	 *
+	 *  All damage (expose requests) is collected and presented at most once
+	 *  per frame interval (default BWIDGETS_DEFAULT_FRAME_RATE). With a
+	 *  frame rate of 0.0, each expose request is posted immediately.
+	 */
+	virtual void setFrameRate (const double fps);
+
+	/**
+	 *  @brief  Gets the target frame rate.
+	 *  @return  Frames per second or 0.0 for unpaced redraw.
+	 */
+	double getFrameRate () const;
+
+	/**
+	 *  @brief  Gets the number of missed frame deadlines.
+	 *  @return  Number of frames presented later than one frame interval
+	 *  after they became due.
+	 */
+	unsigned long getMissedFrames () const;
+
+	/**
+	 *  @brief  Sets the time budget for a single event handling pass.
+	 *  @param seconds  Time in seconds or 0.0 for an unlimited budget.
+	 *
+	 *  Each event handling pass (@c handleEvents() or a single iteration of
+	 *  @c run() ) stops handling events once the time budget (default
+	 *  BWIDGETS_DEFAULT_EVENT_TIME_BUDGET) is exhausted. The remaining events
+	 *  are deferred to the next pass. At least one event is handled per pass.
+	 *  As the events are handled by their priority (input events first, 
+	 *  expose requests last), bursts of value changes or configure requests
+	 *  can't delay new input events for longer than the budget.
+	 */
+	void setEventTimeBudget (const double seconds);
+
+	/**
+	 *  @brief  Gets the time budget for a single event handling pass.
+	 *  @return  Time in seconds or 0.0 for an unlimited budget.
+	 */
+	double getEventTimeBudget () const;
+
+	/**
+	 *  @brief  Gets the performance statistics of the last presented frame.
+	 *  @return  Frame statistics.
+	 *
+	 *  The statistics are always collected. The overhead is a few counters
+	 *  and two clock reads per widget draw.
+	 *
+	 *  The allocations by phase (dispatch, draw, composite) are only counted
+	 *  if BUTILITIES_ALLOCATION_COUNTER is defined (see 
+	 *  BUtilities::AllocationCounter). Otherwise, they are zero. Each Window
+	 *  counts the allocations of its own phases. Allocations of other 
+	 *  Windows in the same process are not included.
+	 */
+	const FrameStatistics& getFrameStatistics () const;
+
+	/**
+	 *  @brief  Switches the damage debug overlay on/off.
+	 *  @param status  True if on, otherwise false (default).
+	 *
+	 *  If on, each expose tints the recomposited areas red and outlines the
+	 *  areas of the widgets drawn for this expose in blue. The overlay is
+	 *  only painted onto the host-provided surface (or the offscreen surface
+	 *  of a headless %Window), not onto the retained window surface. Thus,
+	 *  it stays until the respective area is presented again. Use it to 
+	 *  find over-invalidation. The recomposited areas and their pixel 
+	 *  counts are also available from @c getFrameStatistics() .
+	 */
+	void setDebugDamage (const bool status);
+
+	/**
+	 *  @brief  Information about the damage debug overlay.
+	 *  @return  True if on, otherwise false.
+	 */
+	bool isDebugDamage () const;
+
+	/**
+	 *  @brief  Starts a timer.
+	 *  @param seconds  Time (interval) in seconds.
+	 *  @param func  Callback function to be called from the main %Window
+	 *  event handler.
+	 *  @param periodic  Optional, true for a periodic timer, otherwise 
+	 *  (default) one-shot.
+	 *  @return  Timer ID.
+	 *
+	 *  Timers are processed by the event loop. Thus, @c run() wakes up in 
+	 *  time and @c handleEvents() calls all timers which are due.
+	 */
+	uint32_t addTimer (const double seconds, std::function<void ()> func, const bool periodic = false);
+
+	/**
+	 *  @brief  Stops a timer.
+	 *  @param id  Timer ID.
+	 */
+	void removeTimer (const uint32_t id);
+
+	/**
+	 *  @brief  Adds a frame-synchronized animation.
+	 *  @param func  Callback function to be called once per frame with the
+	 *  time in seconds since the start of the animation. Return false to
+	 *  end the animation.
+	 *  @return  Animation ID.
+	 *
+	 *  Animations are called at the frame rate (see @c setFrameRate() ) 
+	 *  before the damage of the frame is posted.
+	 */
+	uint32_t addAnimation (std::function<bool (const double seconds)> func);
+
+	/**
+	 *  @brief  Ends an animation.
+	 *  @param id  Animation ID.
+	 */
+	void removeAnimation (const uint32_t id);
+
+	/**
+	 *  @brief  Posts a new value for a widget from any thread.
+	 *  @tparam T  Trivially copyable value type (max. 
+	 *  BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE bytes).
+	 *  @param widget  Widget of the type ValueableTyped<T>.
+	 *  @param value  New value.
+	 *  @return  True on success, false if the queue is full.
+	 *
+	 *  Wait-free and allocation-free. Thus, it can be called from realtime
+	 *  threads (e.g., DSP). The value is set by the main %Window event
+	 *  handler (@c handleEvents() ). The first post after the event handler
+	 *  took the posted items wakes up the event loop (see @c wakeUp() ). If multiple values are posted for a
+	 *  widget in the meantime, only the last value is set. Values for widgets
+	 *  which are released from this %Window (or destroyed) before are
+	 *  dropped. The widget must not be destroyed while @c postValue() is 
+	 *  running.
+	 */
+	template <class T>
+	bool postValue (Widget* widget, const T& value);
+
+	/**
+	 *  @brief  Posts a message for a widget from any thread.
+	 *  @tparam T  Trivially copyable content type (max. 
+	 *  BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE bytes).
+	 *  @param widget  Messagable widget.
+	 *  @param name  Message name. Must be a string literal or any other 
+	 *  string with static lifetime.
+	 *  @param content  Message content.
+	 *  @return  True on success, false if the queue is full.
+	 *
+	 *  Wait-free and allocation-free. Thus, it can be called from realtime
+	 *  threads (e.g., DSP). The main %Window event handler 
+	 *  (@c handleEvents() ) emits a MessageEvent for each posted message.
+	 *  The first post after the event handler took the posted items wakes
+	 *  up the event loop (see @c wakeUp() ).
+	 *  Messages for widgets which are released from this %Window (or 
+	 *  destroyed) before are dropped. The widget must not be destroyed while
+	 *  @c postMessage() is running.
+	 */
+	template <class T>
+	bool postMessage (Widget* widget, const char* name, const T& content);
+
+	/**
+	 *  @brief  Switches parallel drawing of widgets on/off.
+	 *  @param status  True if on, otherwise false (default).
+	 *
+	 *  If on, all scheduled draws of the widgets within the exposed region
+	 *  are performed concurrently on a pool of worker threads prior to the
+	 *  composition. Widgets which are not concurrent drawable (see
+	 *  @c Visualizable::setConcurrentDrawable() ) are still drawn on the
+	 *  main thread.
+	 */
+	virtual void setParallelDraw (const bool status);
+
+	/**
+	 *  @brief  Information about parallel drawing of widgets.
+	 *  @return  True if on, otherwise false.
+	 */
+	bool isParallelDraw () const;
+
+	/**
+	 *  @brief  Switches tile-parallel composition on/off.
+	 *  @param status  True if on, otherwise false (default).
+	 *
+	 *  If on, the exposed region is split into tiles of
+	 *  BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE x 
+	 *  BWIDGETS_DEFAULT_COMPOSITE_TILE_SIZE pixels. All layers of each tile
+	 *  are blended on a pool of worker threads.
+	 */
+	virtual void setParallelComposite (const bool status);
+
+	/**
+	 *  @brief  Information about tile-parallel composition.
+	 *  @return  True if on, otherwise false.
+	 */
+	bool isParallelComposite () const;
+
 	/**
 	 *  @brief  Get access to the host system-provided native view via Pugl.
 	 *  @return  Pointer to the PuglView.
@@ -159,10 +613,64 @@ public:
 	 */
 	cairo_t* getCairoContext ();
 
+	/**
+	 *  @brief  Gets the backend of this %Window.
+	 *  @return  BackendType.
+	 */
+	BackendType getBackend () const;
+
+	/**
+	 *  @brief  Gets the offscreen surface of a headless %Window.
+	 *  @return  Pointer to the Cairo image surface or nullptr if not 
+	 *  headless or not exposed yet.
+	 *
+	 *  The offscreen surface has got the zoomed window resolution and 
+	 *  contains the content presented by the last expose.
+	 */
+	cairo_surface_t* getOffscreenSurface ();
+
+	/**
+	 *  @brief  Passes a synthetic host event to the %Window.
+	 *  @param event  PuglEvent.
+	 *  @return  PuglStatus.
+	 *
+	 *  The event is translated like an event provided by the host system 
+	 *  (see @c translatePuglEvent() ). Resulting events are handled by the 
+	 *  next call of @c handleEvents() . Wakes up a waiting @c run() .
+	 */
+	PuglStatus injectEvent (const PuglEvent& event);
+
+	/**
+	 *  @brief  Starts recording the host events to a file.
+	 *  @param filename  File name.
+	 *  @return  True on success, otherwise false.
+	 *
+	 *  Records all motion, button, key, text, scroll, and configure events
+	 *  passed to this %Window (by the host system or by @c injectEvent() )
+	 *  with their time stamps (see EventRecorder). A recording can be
+	 *  replayed by EventReplay.
+	 */
+	bool startRecording (const std::string& filename);
+
+	/**
+	 *  @brief  Ends the recording of host events.
+	 */
+	void stopRecording ();
+
+	/**
+	 *  @brief  Information about a running recording of host events.
+	 *  @return  True if recording, otherwise false.
+	 */
+	bool isRecording () const;
+
 	/**
 	 *  @brief  Runs the %Window until it get closed.
 	 *
-	 *  For stand-alone applications.
+	 *  For stand-alone applications. Sleeps until the next host event or the
+	 *  next internal deadline (frame, timer, animation). Thus, an idle 
+	 *  %Window doesn't consume CPU time. Then calls @c handleEvents() .
+	 *  Thus, overridden @c handleEvents() methods are also used in 
+	 *  stand-alone mode.
 	 */
 	virtual void run ();
 
@@ -180,20 +688,42 @@ public:
 	 *  2. must NOT be deleted outside once it is passed to the Window object.
 	 *
 	 *  Also tries to merge the @a event
-	 *  with the previous event of the queue if:
+	 *  with the last queued event of the same type and widget if:
 	 *  1. Both events are the same type.
 	 *  2. The event type is eligible for merging.
 	 *  3. Both events are emitted by the same widget.
 	 *  4. The emitting widget allows event merging for the respective event
 	 *     type (see @c EventMergeable::setEventMergeable() ).
+	 *
+	 *  The last queued mergeable event for each widget and event type is
+	 *  looked up in a hash index. Thus, merging doesn't depend on the 
+	 *  length of the event queue.
 	 */
 	virtual void addEventToQueue (BEvents::Event* event) override;
 
+	/**
+	 *  @brief  Pops the event from the front of the event queue.
+	 *  @return  Pointer to the event beeing in front of the event queue or
+	 *  nullptr if empty.
+	 */
+	virtual BEvents::Event* popEvent () override;
+
+	/**
+	 *  @brief  Pops the event from from somewhere in the event queue.
+	 *  @param event  Pointer to the event to be popped.
+	 *  @return  Pointer to the event or nullptr if not present.
+	 */
+	virtual BEvents::Event* popEvent (BEvents::Event* event) override;
+
 	/**
 	 *  @brief  Main Event handler. 
 	 *
 	 *  Iterates through the event queue, analyzes the events, and and routes
-	 *  them to their respective @c onXXX() handling methods.
+	 *  them to their respective @c onXXX() handling methods. Events are 
+	 *  handled by their priority until the queue is empty or the event time
+	 *  budget is exhausted (see @c setEventTimeBudget() ).
+	 *
+	 *  Non-blocking. To be called periodically by plugin hosts.
 	 */
 	virtual void handleEvents ();
 
@@ -207,6 +737,13 @@ public:
 	 *  which is then interpreted in the @c translatePuglEvent() method where
 	 *  it calls drawing of all linked child widget RGBA surfaces to the host
 	 *  provided RGBA surface.
+	 *
+	 *  Each area of the expose event region is added to the damaged region
+	 *  of the %Window. The damaged areas are posted to the host system 
+	 *  separately at the next frame deadline (see @c setFrameRate() ). Thus,
+	 *  only the damaged areas will be recomposited. If the damaged region
+	 *  becomes too fragmented (more than BWIDGETS_DEFAULT_MAX_DAMAGE_AREAS
+	 *  areas), it falls back to its bounding box.
 	 */
 	virtual void onExposeRequest (BEvents::Event* event) override;
 
@@ -229,6 +766,9 @@ public:
 	/**
 	 *  @brief  Removes events from the event queue.
 	 *  @param widget  Emitting widget (nullptr for all widgets).
+	 *
+	 *  Each widget links the queued events which refer to it. Thus, 
+	 *  purging a widget only visits its own events.
 	 */
 	virtual void purgeEventQueue (Widget* widget = nullptr);
 
@@ -239,6 +779,10 @@ public:
 	bool isQuit () const;
 
 private:
+	Window	(const BackendType backend, const double width, const double height, PuglNativeView nativeWindow, 
+			 uint32_t urid, std::string title, bool resizable,
+			 PuglWorldType worldType, int worldFlag);
+
 	/**
 	 *  @brief  Static event translation method to be called by Pugl.
 	 *  @param view  Pointer to the PuglView.
@@ -256,11 +800,306 @@ private:
 	 */
 	static PuglStatus translatePuglEvent (PuglView* view, const PuglEvent* event);
 
+	/**
+	 *  @brief  Translates a host event for this %Window. Called by 
+	 *  @c translatePuglEvent() and @c injectEvent() .
+	 *  @param event  Pointer to the PuglEvent.
+	 *  @return  PuglStatus.
+	 */
+	PuglStatus translateEvent (const PuglEvent* event);
+
+	/**
+	 *  @brief  Exposes the damage posted to a headless %Window.
+	 */
+	void exposeOffscreen ();
+
+	/**
+	 *  @brief  (Re-)creates the retained window surface if it doesn't match
+	 *  the window extends.
+	 *  @return  True if the surfaces were (re-)created and thus don't 
+	 *  contain any retained content, otherwise false.
+	 *
+	 *  The composed window surface and the window-sized layer surfaces 
+	 *  survive between exposes. Thus, an expose only needs to redraw the 
+	 *  damaged area of the layers and to recomposite it. The layer surfaces
+	 *  are dropped together with the window surface and re-created on 
+	 *  demand by @c display().
+	 */
+	bool validateSurfaces ();
+
+	/**
+	 *  @brief  Destroys the retained window surface and the layer surfaces.
+	 */
+	void destroySurfaces ();
+
+	/**
+	 *  @brief  Waits for host events and translates them.
+	 *  @param timeout  Maximum time to wait for host events in seconds. 0.0
+	 *  doesn't wait, a negative value waits until the next host event.
+	 *
+	 *  Without a windowing system (BackendType::headless), waits until the
+	 *  timeout or until @c wakeUp() is called.
+	 */
+	void waitForEvents (const double timeout);
+
+	/**
+	 *  @brief  Gets the time until the next internal deadline.
+	 *  @return  Time in seconds, 0.0 if events are pending, or -1.0 if there
+	 *  isn't any deadline.
+	 */
+	double getTimeout () const;
+
+	/**
+	 *  @brief  Posts all areas of the damaged region to the host system.
+	 */
+	void postDamage ();
+
+	/**
+	 *  @brief  Gets the frame interval.
+	 *  @return  Frame interval or zero if unpaced.
+	 */
+	std::chrono::steady_clock::duration getFrameInterval () const;
+
+	/**
+	 *  @brief  Blends all layered surfaces within a region onto the retained
+	 *  window surface.
+	 *  @param region  Region.
+	 *  @param box  Area covered by the layered surfaces.
+	 */
+	void composite (const BUtilities::Region<>& region, const BUtilities::Area<>& box);
+
+	/**
+	 *  @brief  Blends all layered surfaces within a region onto the retained
+	 *  window surface. Tile-parallel version.
+	 *  @param region  Region.
+	 *  @param box  Area covered by the layered surfaces.
+	 */
+	void compositeTiled (const BUtilities::Region<>& region, const BUtilities::Area<>& box);
+
+	/**
+	 *  @brief  Gets the thread pool. Creates the thread pool on the first
+	 *  call.
+	 *  @return  Reference to the thread pool.
+	 */
+	BUtilities::ThreadPool& getThreadPool ();
+
+	/**
+	 *  @brief  Draws all scheduled and concurrent drawable widgets within a
+	 *  region in parallel.
+	 *  @param region  Region.
+	 */
+	void drawParallel (const BUtilities::Region<>& region);
+
+	/**
+	 *  @brief  Applies all values and messages posted from other threads.
+	 *
+	 *  Only the last value posted for a widget is applied. Messages are all
+	 *  emitted in order.
+	 */
+	void processCrossThreadItems ();
+
+	/**
+	 *  @brief  Wakes up the event loop from any thread.
+	 *
+	 *  Only the first call after the event handler (@c handleEvents() )
+	 *  started takes effect. It sends a PUGL_CLIENT event to the view or 
+	 *  notifies the waiting headless %Window. Thus, @c run() returns from 
+	 *  waiting. Called by @c postValue() , @c postMessage() , 
+	 *  @c injectEvent() , @c addTimer() , and @c addAnimation() .
+	 */
+	void wakeUp ();
+
+	/**
+	 *  @brief  Drops all values and messages posted for a widget so far.
+	 *  @param widget  Widget released from this %Window.
+	 *
+	 *  Called by Widget::release(). The widget may be destroyed afterwards.
+	 */
+	void purgeCrossThreadItems (Widget* widget);
+
+	/**
+	 *  @brief  Emits a MessageEvent for a message posted from another thread.
+	 */
+	void addMessage (Widget* widget, const char* name, const BUtilities::Any& content);
+
+	/**
+	 *  @brief  Calls all due timers.
+	 */
+	void processTimers ();
+
+	/**
+	 *  @brief  Calls all animations if the next animation frame is due.
+	 */
+	void processAnimations ();
+
+	/**
+	 *  @brief  (Re-)sets the deadlines for the pointer focus in and out of a 
+	 *  widget.
+	 *  @param widget  Widget with the grabbed pointer.
+	 *
+	 *  Only updates two time points. Thus, it can be called on each pointer
+	 *  motion without allocation.
+	 */
+	void scheduleFocus (Widget* widget);
+
+	/**
+	 *  @brief  Checks for pointer focus in and out if the respective 
+	 *  deadline is due.
+	 */
+	void processFocus ();
+
+	/**
+	 *  @brief  Adds a widget to the registry of the widgets which grabbed a
+	 *  device. Called by Widget::grabDevice().
+	 *  @param widget  Widget.
+	 *  @param device  Device.
+	 */
+	void addDeviceGrab (Widget* widget, const BDevices::Device& device);
+
+	/**
+	 *  @brief  Removes a widget from the registry of the widgets which 
+	 *  grabbed a device. Called by Widget::freeDevice().
+	 *  @param widget  Widget.
+	 *  @param device  Device.
+	 */
+	void removeDeviceGrab (Widget* widget, const BDevices::Device& device);
+
+	/**
+	 *  @brief  (Re-)builds the hit test index if invalidated.
+	 *
+	 *  The hit test index stores the visible area of each visible widget
+	 *  (clipped like in @c Widget::getWidgetAt() ) in the tree order. And it
+	 *  stores the indexes of the areas in a uniform grid of cells with the 
+	 *  size BWIDGETS_DEFAULT_HIT_INDEX_CELL_SIZE. The index is valid until a
+	 *  widget of this %Window invalidates it (see 
+	 *  Widget::invalidateGeometry() ).
+	 */
+	void validateHitIndex ();
+
+	/**
+	 *  @brief  Adds a widget and its children to the hit test index.
+	 */
+	void buildHitIndex	(Widget* widget, const size_t parent, const BUtilities::Point<>& abspos,
+						 const BUtilities::Area<>& outerArea, const BUtilities::Area<>& area);
+
+	/**
+	 *  @brief  Gets the top widget at an absolute position using the hit
+	 *  test index.
+	 *  @param abspos  Absolute position.
+	 *  @param func  Filter function.
+	 *  @param passfunc  Function to skip a widget.
+	 *  @return  Pointer to the widget.
+	 *
+	 *  Same result as the recursive @c Widget::getWidgetAt() . But only the
+	 *  widgets of the grid cell at @a abspos and their parents are 
+	 *  evaluated.
+	 */
+	Widget* getIndexedWidgetAt	(const BUtilities::Point<>& abspos, 
+								 std::function<bool (Widget* widget)> func,
+								 std::function<bool (Widget* widget)> passfunc);
+
+	/**
+	 *  @brief  Links a newly queued event to the event lists of the 
+	 *  referred widgets.
+	 */
+	void indexEvent (BEvents::Event* event);
+
+	/**
+	 *  @brief  Unlinks a popped event from the event lists of the referred
+	 *  widgets.
+	 */
+	void unindexEvent (BEvents::Event* event);
+
+	/**
+	 *  @brief  Adds a widget draw to the statistics of the current frame.
+	 *  @param widget  Drawn widget.
+	 *  @param time  Time spent in @c draw() .
+	 */
+	void addDrawStatistics (const Widget* widget, const std::chrono::steady_clock::duration time);
+
+	/**
+	 *  @brief  Adds a newly allocated surface to the statistics of the 
+	 *  current frame.
+	 *  @param surface  Cairo image surface.
+	 */
+	void addSurfaceStatistics (cairo_surface_t* surface);
+
+	/**
+	 *  @brief  Adds the recomposited areas to the statistics of the current
+	 *  frame.
+	 *  @param region  Recomposited region.
+	 */
+	void addDamageStatistics (const BUtilities::Region<>& region);
+
+	/**
+	 *  @brief  Paints the damage debug overlay (see @c setDebugDamage() ).
+	 *  @param cr  Cairo context of the host-provided surface.
+	 *  @param region  Recomposited region.
+	 */
+	void paintDebugDamage (cairo_t* cr, const BUtilities::Region<>& region);
+
+	/**
+	 *  @brief  Completes the statistics of the current frame upon its 
+	 *  presentation and starts the statistics of the next frame.
+	 */
+	void finishFrameStatistics ();
+
 	void translateTimeEvent ();
 
 	void unfocus();
 };
 
+template <class T>
+inline bool Window::postValue (Widget* widget, const T& value)
+{
+	static_assert (std::is_trivially_copyable<T>::value, "postValue requires trivially copyable values");
+	static_assert (sizeof (T) <= BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE, "Value too big for postValue");
+
+	CrossThreadItem item;
+	item.kind = CrossThreadKind::value;
+	item.widget = widget;
+	item.generation = crossThreadGeneration_.load (std::memory_order_acquire);
+	item.name = nullptr;
+	item.apply = [] (Window*, Widget* widget, const char*, const void* data)
+	{
+		T v;
+		std::memcpy (&v, data, sizeof (T));
+		ValueableTyped<T>* vt = dynamic_cast<ValueableTyped<T>*> (widget);
+		if (vt) vt->setValue (v);
+	};
+	std::memcpy (item.data, &value, sizeof (T));
+
+	crossThreadUsed_.store (true, std::memory_order_relaxed);
+	if (!crossThreadQueue_.push (item)) return false;
+	wakeUp ();
+	return true;
+}
+
+template <class T>
+inline bool Window::postMessage (Widget* widget, const char* name, const T& content)
+{
+	static_assert (std::is_trivially_copyable<T>::value, "postMessage requires trivially copyable content");
+	static_assert (sizeof (T) <= BWIDGETS_DEFAULT_CROSS_THREAD_DATA_SIZE, "Content too big for postMessage");
+
+	CrossThreadItem item;
+	item.kind = CrossThreadKind::message;
+	item.widget = widget;
+	item.generation = crossThreadGeneration_.load (std::memory_order_acquire);
+	item.name = name;
+	item.apply = [] (Window* window, Widget* widget, const char* name, const void* data)
+	{
+		T v;
+		std::memcpy (&v, data, sizeof (T));
+		window->addMessage (widget, name, BUtilities::makeAny<T> (v));
+	};
+	std::memcpy (item.data, &content, sizeof (T));
+
+	crossThreadUsed_.store (true, std::memory_order_relaxed);
+	if (!crossThreadQueue_.push (item)) return false;
+	wakeUp ();
+	return true;
+}
+
 }
 
 
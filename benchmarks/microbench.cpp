@@ -0,0 +1,108 @@
+/* microbench.cpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ *  Microbenchmarks for the BUtilities and BStyles primitives used in each
+ *  frame: Urid::urid, Style::getBorder, Any copy, Dictionary::get, and
+ *  Area / Point arithmetic. Results are written as JSON to stdout.
+ *
+ *  Usage: microbench [iterations]   (default: 1000000)
+ */
+
+#include "../BUtilities/Urid.hpp"
+#include "../BUtilities/Dictionary.hpp"
+#include "../BUtilities/Any.hpp"
+#include "../BUtilities/Area.hpp"
+#include "../BUtilities/Point.hpp"
+#include "../BStyles/Style.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#define URI "https://github.com/sjaehn/BWidgets/microbench.cpp"
+
+using namespace BUtilities;
+using namespace BStyles;
+
+static volatile double sink = 0.0;
+
+/*
+ *  Calls func iterations times and prints the time per call in ns.
+ */
+template <class Func>
+static void measure (const char* name, const size_t iterations, Func func, const bool last = false)
+{
+    // Warm up
+    for (size_t i = 0; i < iterations / 10; ++i) func (i);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) func (i);
+    const double t = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now() - start).count();
+
+    printf ("  {\"name\": \"%s\", \"iterations\": %zu, \"ns\": %.3f}%s\n", name, iterations, t / iterations, (last ? "" : ","));
+    fflush (stdout);
+}
+
+int main (int argc, char* argv[])
+{
+    const long n = (argc > 1 ? std::atol (argv[1]) : 0);
+    const size_t iterations = (n > 0 ? n : 1000000);
+
+    // Fill the URID map with some more URIs as in a real UI
+    for (int i = 0; i < 1000; ++i) Urid::urid (URI "/widget" + std::to_string (i));
+    const std::string uri = URI "/widget500";
+
+    Style style = Style
+    ({
+        {Urid::urid (BSTYLES_STYLEPROPERTY_BORDER_URI), makeAny<Border> (whiteBorder1pt)},
+        {Urid::urid (BSTYLES_STYLEPROPERTY_BACKGROUND_URI), makeAny<Fill> (Fill (darkgrey))},
+        {Urid::urid (BSTYLES_STYLEPROPERTY_FGCOLORS_URI), makeAny<ColorMap> (reds)}
+    });
+    const Style emptyStyle = Style ();
+
+    const Any anyDouble = makeAny<double> (1.0);
+    const Any anyColorMap = makeAny<ColorMap> (reds);
+
+    Dictionary::add ("Cancel", {{"de_DE", "Abbrechen"}, {"fr_FR", "Annuler"}});
+    Dictionary::setLanguage ("de_DE");
+
+    const Area<> a1 (10.0, 20.0, 100.0, 50.0);
+    const Area<> a2 (60.0, 40.0, 100.0, 50.0);
+    const Point<> p1 (15.0, 25.0);
+
+    printf ("{\"benchmark\": \"microbench\", \"unit\": \"ns\", \"results\": [\n");
+
+    measure ("Urid::urid", iterations, [&] (size_t) {sink = sink + Urid::urid (uri);});
+    measure ("Urid::uri", iterations, [&] (size_t i) {sink = sink + Urid::uri (i % 1000 + 1).size();});
+    measure ("Style::getBorder", iterations, [&] (size_t) {sink = sink + style.getBorder().line.width;});
+    measure ("Style::getBorder (fallback)", iterations, [&] (size_t) {sink = sink + emptyStyle.getBorder().line.width;});
+    measure ("Style::getFgColors", iterations, [&] (size_t) {sink = sink + style.getFgColors().size();});
+    measure ("Any copy (double)", iterations, [&] (size_t) {Any a (anyDouble); sink = sink + a.get<double>();});
+    measure ("Any copy (ColorMap)", iterations, [&] (size_t) {Any a (anyColorMap); sink = sink + a.get<ColorMap>().size();});
+    measure ("Style copy", iterations, [&] (size_t) {Style s (style); sink = sink + s.size();});
+    measure ("Dictionary::get", iterations, [&] (size_t) {sink = sink + Dictionary::get ("Cancel").size();});
+    measure ("Dictionary::get (fallback)", iterations, [&] (size_t) {sink = sink + Dictionary::get ("Unknown").size();});
+    measure ("Point arithmetic", iterations, [&] (size_t i) {const Point<> p = (p1 + Point<> (i, i)) * 0.5 - p1; sink = sink + p.x + p.y;});
+    measure ("Area::contains", iterations, [&] (size_t i) {sink = sink + a1.contains (Point<> (i % 200, i % 100));});
+    measure ("Area::overlaps", iterations, [&] (size_t) {sink = sink + a1.overlaps (a2);});
+    measure ("Area union", iterations, [&] (size_t) {const Area<> a = a1 + a2; sink = sink + a.getWidth();});
+    measure ("Area intersection", iterations, [&] (size_t) {const Area<> a = a1 * a2; sink = sink + a.getWidth();}, true);
+
+    printf ("]}\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+/* uibench.cpp
+ * Copyright (C) 2023  Sven Jähnichen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ *  End-to-end UI benchmark. Builds synthetic UIs of different widget counts
+ *  in a headless Window and measures construction, setTheme, full expose,
+ *  single widget update, pointer motion dispatch, and teardown. Results are
+ *  written as JSON to stdout.
+ *
+ *  Usage: uibench [count ...]   (default counts: 10 100 1000 10000)
+ */
+
+#include "../BWidgets/Window.hpp"
+#include "../BWidgets/Knob.hpp"
+#include "../BWidgets/HMeter.hpp"
+#include "../BWidgets/Pad.hpp"
+#include "../BWidgets/Label.hpp"
+#include "../BWidgets/ListBox.hpp"
+#include "../BWidgets/Pattern.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#define URI "https://github.com/sjaehn/BWidgets/uibench.cpp"
+
+#define CELL_SIZE 24.0
+#define WIDGET_SIZE 20.0
+#define REPEATS 100
+
+using namespace BWidgets;
+using namespace BStyles;
+using namespace BUtilities;
+
+struct Result
+{
+    size_t count;
+    double construct;
+    double setTheme;
+    double expose;
+    double update;
+    double pointerMotion;
+    double teardown;
+};
+
+static double since (const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+}
+
+static Widget* createWidget (const size_t i, const double x, const double y)
+{
+    Widget* w = nullptr;
+    switch (i % 6)
+    {
+        case 0:     w = new Knob (Urid::urid (URI "/knob"), std::string ("knob"));
+                    break;
+        case 1:     w = new HMeter (Urid::urid (URI "/meter"), std::string ("meter"));
+                    break;
+        case 2:     w = new Pad<> (Urid::urid (URI "/pad"), std::string ("pad"));
+                    break;
+        case 3:     w = new Label ("Label", Urid::urid (URI "/label"));
+                    break;
+        case 4:     return new ListBox (x, y, WIDGET_SIZE, WIDGET_SIZE, {"1", "2", "3"}, 1, Urid::urid (URI "/listbox"));
+        default:    return new Pattern<> (x, y, WIDGET_SIZE, WIDGET_SIZE, 2, 2, Urid::urid (URI "/pattern"));
+    }
+
+    w->moveTo (x, y);
+    w->resize (WIDGET_SIZE, WIDGET_SIZE);
+    return w;
+}
+
+static Result benchmark (const size_t count)
+{
+    Result r {count, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    const size_t columns = std::max (static_cast<size_t> (std::ceil (std::sqrt (static_cast<double> (count)))), static_cast<size_t> (1));
+    const size_t rows = (count + columns - 1) / columns;
+    const Theme theme = Theme
+    ({
+        {Urid::urid (URI "/knob"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_FGCOLORS_URI), makeAny<ColorMap>(reds)}})},
+        {Urid::urid (URI "/meter"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_FGCOLORS_URI), makeAny<ColorMap>(greens)}})},
+        {Urid::urid (URI "/pad"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_BACKGROUND_URI), makeAny<Fill>(Fill (darkgrey))}})},
+        {Urid::urid (URI "/label"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_TXCOLORS_URI), makeAny<ColorMap>(whites)}})},
+        {Urid::urid (URI "/listbox"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_BORDER_URI), makeAny<Border>(whiteBorder1pt)}})},
+        {Urid::urid (URI "/pattern"), Style ({{Urid::urid (BSTYLES_STYLEPROPERTY_BACKGROUND_URI), makeAny<Fill>(Fill (black))}})}
+    });
+
+    // Construction
+    std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+    std::unique_ptr<Window> window (new Window (columns * CELL_SIZE, rows * CELL_SIZE, Window::BackendType::headless));
+    window->setFrameRate (0.0);
+    window->setEventTimeBudget (0.0);
+    std::vector<std::unique_ptr<Widget>> widgets;
+    widgets.reserve (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        widgets.emplace_back (createWidget (i, (i % columns) * CELL_SIZE, (i / columns) * CELL_SIZE));
+        window->add (widgets.back().get());
+    }
+    r.construct = since (t);
+
+    // setTheme
+    t = std::chrono::steady_clock::now();
+    window->setTheme (theme);
+    r.setTheme = since (t);
+
+    // Full expose (handles all pending events including the first expose)
+    t = std::chrono::steady_clock::now();
+    window->handleEvents ();
+    window->emitExposeEvent ();
+    window->handleEvents ();
+    r.expose = since (t);
+
+    // Single widget update
+    t = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < REPEATS; ++i)
+    {
+        widgets[(i * 7919) % count]->update ();
+        window->handleEvents ();
+    }
+    r.update = since (t) / REPEATS;
+
+    // Pointer motion dispatch
+    t = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < REPEATS; ++i)
+    {
+        PuglEvent event {};
+        event.motion.type = PUGL_MOTION;
+        event.motion.x = std::fmod (i * 37.0, columns * CELL_SIZE);
+        event.motion.y = std::fmod (i * 53.0, rows * CELL_SIZE);
+        window->injectEvent (event);
+        window->handleEvents ();
+    }
+    r.pointerMotion = since (t) / REPEATS;
+
+    // Teardown
+    t = std::chrono::steady_clock::now();
+    widgets.clear ();
+    window.reset ();
+    r.teardown = since (t);
+
+    return r;
+}
+
+int main (int argc, char* argv[])
+{
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i)
+    {
+        const long c = std::atol (argv[i]);
+        if (c > 0) counts.push_back (c);
+    }
+    if (counts.empty()) counts = {10, 100, 1000, 10000};
+
+    printf ("{\"benchmark\": \"uibench\", \"unit\": \"s\", \"results\": [\n");
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        const Result r = benchmark (counts[i]);
+        printf  ("  {\"widgets\": %zu, \"construct\": %.9f, \"setTheme\": %.9f, \"expose\": %.9f, \"update\": %.9f, \"pointerMotion\": %.9f, \"teardown\": %.9f}%s\n",
+                 r.count, r.construct, r.setTheme, r.expose, r.update, r.pointerMotion, r.teardown, (i + 1 < counts.size() ? "," : ""));
+        fflush (stdout);
+    }
+    printf ("]}\n");
+    return 0;
+}